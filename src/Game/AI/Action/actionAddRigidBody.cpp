@@ -1,7 +1,14 @@
 #include "Game/AI/Action/actionAddRigidBody.h"
+#include "KingSystem/ActorSystem/actAiClassDef.h"
 
 namespace uking::action {
 
+static ksys::act::ai::StaticParamSlot sStaticParams[] = {
+    ksys::act::ai::StaticParamSlot{"ResetLayer"},
+};
+static ksys::act::ai::StaticParamSlotTable sStaticParamTable{ksys::AIDefType::Action,
+                                                             "AddRigidBody", sStaticParams};
+
 AddRigidBody::AddRigidBody(const InitArg& arg) : ksys::act::ai::Action(arg) {}
 
 AddRigidBody::~AddRigidBody() = default;
@@ -19,7 +26,7 @@ void AddRigidBody::leave_() {
 }
 
 void AddRigidBody::loadParams_() {
-    getStaticParam(&mResetLayer_s, "ResetLayer");
+    getStaticParam(&mResetLayer_s, &sStaticParams[0]);
 }
 
 void AddRigidBody::calc_() {
@@ -1,5 +1,6 @@
 #include "Game/AI/Query/queryCheckAreaTransition.h"
 #include <evfl/Query.h>
+#include "KingSystem/ActorSystem/actAiClassDef.h"
 
 namespace uking::query {
 
@@ -17,8 +18,14 @@ void CheckAreaTransition::loadParams(const evfl::QueryArg& arg) {
     loadInt(arg.param_accessor, "PostAreaNo");
 }
 
+static ksys::act::ai::StaticParamSlot sStaticParams[] = {
+    ksys::act::ai::StaticParamSlot{"CheckDistFront"},
+};
+static ksys::act::ai::StaticParamSlotTable sStaticParamTable{ksys::AIDefType::Query,
+                                                             "CheckAreaTransition", sStaticParams};
+
 void CheckAreaTransition::loadParams() {
-    getStaticParam(&mCheckDistFront, "CheckDistFront");
+    getStaticParam(&mCheckDistFront, &sStaticParams[0]);
     getDynamicParam(&mCurrentAreaNo, "CurrentAreaNo");
     getDynamicParam(&mPostAreaNo, "PostAreaNo");
 }
@@ -1,11 +1,13 @@
 #include "Game/UI/uiPauseMenuDataMgr.h"
 #include <algorithm>
+#include <basis/seadRawPrint.h>
 #include <container/seadBuffer.h>
 #include <limits>
 #include <math/seadMathCalcCommon.h>
 #include <prim/seadScopedLock.h>
 #include "Game/Actor/actWeapon.h"
 #include "Game/DLC/aocManager.h"
+#include "Game/UI/uiPouchItemIndex.h"
 #include "Game/UI/uiUtils.h"
 #include "Game/gameScene.h"
 #include "KingSystem/ActorSystem/Profiles/actPlayerBase.h"
@@ -31,6 +33,16 @@ sead::Vector2f sDummyCookEffect0{-1, 0};
 
 namespace {
 
+/// Index over the item list of the PauseMenuDataMgr instance, owned by init() and the destructor.
+/// Kept outside of the manager so that the manager keeps its original layout.
+PouchItemIndex* sItemIndex = nullptr;
+
+/// Must be called before an item is removed from the item list.
+void removeFromItemIndex(const PouchItem* item) {
+    if (sItemIndex)
+        sItemIndex->removeItem(item);
+}
+
 sead::SafeArray<CookTagInfo, 11> sCookItemOrder_{{
     {1, "CookFruit", ksys::act::tags::CookFruit},
     {1, "CookMushroom", ksys::act::tags::CookMushroom},
@@ -233,7 +245,10 @@ PauseMenuDataMgr::PauseMenuDataMgr() {
     resetEquippedItemArray();
 }
 
-PauseMenuDataMgr::~PauseMenuDataMgr() = default;
+PauseMenuDataMgr::~PauseMenuDataMgr() {
+    delete sItemIndex;
+    sItemIndex = nullptr;
+}
 
 PouchItem::PouchItem() {
     mData.cook.mCookEffect0 = sDummyCookEffect0;
@@ -241,6 +256,17 @@ PouchItem::PouchItem() {
         mIngredients.emplaceBack();
 }
 
+PouchItemIndex& PauseMenuDataMgr::getItemIndex() const {
+    SEAD_ASSERT_MSG(sItemIndex, "PauseMenuDataMgr::init has not been called");
+    if (!sItemIndex->isValid())
+        sItemIndex->build(getItems(), &mItemLists.buffer[0]);
+#ifdef SEAD_DEBUG
+    // Catches item list changes that were not reported to the index.
+    SEAD_ASSERT_MSG(sItemIndex->checkConsistency(getItems()), "stale pouch item index");
+#endif
+    return *sItemIndex;
+}
+
 void PauseMenuDataMgr::resetItem() {
     mNewlyAddedItem.mType = PouchItemType::Invalid;
     mNewlyAddedItem.mItemUse = ItemUse::Invalid;
@@ -262,11 +288,15 @@ void PauseMenuDataMgr::setItemModifier(PouchItem& item, const act::WeaponModifie
     }
 }
 
-void PauseMenuDataMgr::init(sead::Heap* heap) {}
+void PauseMenuDataMgr::init(sead::Heap* heap) {
+    sItemIndex = new (heap) PouchItemIndex;
+}
 
 void PauseMenuDataMgr::initForNewSave() {
     const auto lock = sead::makeScopedLock(mCritSection);
 
+    if (sItemIndex)
+        sItemIndex->invalidate();
     for (auto* item = getItems().popFront(); item; item = getItems().popFront())
         destroyAndRecycleItem(item);
 
@@ -327,6 +357,8 @@ void PauseMenuDataMgr::doLoadFromGameData() {
     const auto lock = sead::makeScopedLock(mCritSection);
     auto& lists = mItemLists;
 
+    if (sItemIndex)
+        sItemIndex->invalidate();
     for (auto* item = lists.list1.popFront(); item; item = lists.list1.popFront())
         destroyAndRecycleItem(item);
 
@@ -347,9 +379,18 @@ void PauseMenuDataMgr::doLoadFromGameData() {
     mLastAddedItem = nullptr;
     bool found_travel_medallion = false;
 
+    // Read the item arrays in one go instead of going through the flag manager for every item.
+    const char* names[NumPouchItemsMax];
+    bool equip_flags[NumPouchItemsMax]{};
+    s32 values[NumPouchItemsMax]{};
+    const s32 num_names = gdt::getStr64Span(gdt::flag_PorchItem(), names, 0, NumPouchItemsMax);
+    for (s32 i = num_names; i < NumPouchItemsMax; ++i)
+        names[i] = "";
+    gdt::getBoolSpan(gdt::flag_PorchItem_EquipFlag(), equip_flags, 0, num_names);
+    gdt::getS32Span(gdt::flag_PorchItem_Value1(), values, 0, num_names);
+
     for (u32 idx = 0; idx < u32(NumPouchItemsMax); ++idx) {
-        const char* item_name;
-        gdt::getFlag_PorchItem(&item_name, idx);
+        const char* item_name = names[idx];
 
         if (found_travel_medallion || sValues.Obj_WarpDLC == item_name)
             found_travel_medallion = true;
@@ -357,8 +398,8 @@ void PauseMenuDataMgr::doLoadFromGameData() {
         if (sead::SafeString(item_name).isEmpty())
             break;
 
-        const bool equipped = gdt::getFlag_PorchItem_EquipFlag(idx);
-        const s32 value = gdt::getFlag_PorchItem_Value1(idx);
+        const bool equipped = equip_flags[idx];
+        const s32 value = values[idx];
         const auto type = getType(item_name);
 
         switch (type) {
@@ -901,7 +942,19 @@ void PauseMenuDataMgr::addToPouch(const sead::SafeString& name, PouchItemType ty
     }
 
     if (type != PouchItemType::Invalid) {
+        // Free items are reset to an invalid type, so the item that was taken from the free list
+        // (if any) can be told apart from the ones that are still free.
+        auto* new_item = lists.list2.front();
+        const s32 num_items = lists.list1.size();
         doAddToPouch(type, name, lists, value, equipped, modifier, is_inventory_load);
+        if (sItemIndex && lists.list1.size() != num_items) {
+            if (lists.list1.size() == num_items + 1 && new_item &&
+                new_item->getType() != PouchItemType::Invalid) {
+                sItemIndex->addItem(new_item);
+            } else {
+                sItemIndex->invalidate();
+            }
+        }
 
         updateAfterAddingItem(true);
         updateInventoryInfo(lists.list1);
@@ -930,11 +983,17 @@ void PauseMenuDataMgr::saveToGameData(const sead::OffsetList<PouchItem>& list) c
     s32 num_shields = 0;
     s32 num_bows = 0;
 
+    // The item arrays are filled here and written in one go at the end.
+    const char* names[NumPouchItemsMax];
+    bool equip_flags[NumPouchItemsMax];
+    s32 values[NumPouchItemsMax];
+    s32 num_entries = NumPouchItemsMax;
+
     for (idx = 0; idx < NumPouchItemsMax; ++idx) {
         if (!item) {
-            ksys::gdt::setFlag_PorchItem({}, idx);
-            ksys::gdt::setFlag_PorchItem_EquipFlag(false, idx);
-            ksys::gdt::setFlag_PorchItem_Value1(0, idx);
+            names[idx] = "";
+            equip_flags[idx] = false;
+            values[idx] = 0;
             continue;
         }
 
@@ -946,13 +1005,14 @@ void PauseMenuDataMgr::saveToGameData(const sead::OffsetList<PouchItem>& list) c
         }
 
         if (!item) {
-            ksys::gdt::setFlag_PorchItem({}, idx);
-            ksys::gdt::setFlag_PorchItem_EquipFlag(false, idx);
-            ksys::gdt::setFlag_PorchItem_Value1(0, idx);
-            return;
+            names[idx] = "";
+            equip_flags[idx] = false;
+            values[idx] = 0;
+            num_entries = idx + 1;
+            break;
         }
 
-        sead::FixedSafeString<64> name{item->getName()};
+        const auto& name = item->getName();
         s32 value = item->getValue();
         for (const auto& entry : mGrabbedItems) {
             if (entry.item == item) {
@@ -961,9 +1021,9 @@ void PauseMenuDataMgr::saveToGameData(const sead::OffsetList<PouchItem>& list) c
             }
         }
         const auto type = item->getType();
-        ksys::gdt::setFlag_PorchItem(name, idx);
-        ksys::gdt::setFlag_PorchItem_EquipFlag(item->isEquipped(), idx);
-        ksys::gdt::setFlag_PorchItem_Value1(value, idx);
+        names[idx] = name.cstr();
+        equip_flags[idx] = item->isEquipped();
+        values[idx] = value;
         switch (type) {
         case PouchItemType::Sword:
             if (num_swords < NumSwordsMax) {
@@ -1013,6 +1073,10 @@ void PauseMenuDataMgr::saveToGameData(const sead::OffsetList<PouchItem>& list) c
 
         item = list.next(item);
     }
+
+    ksys::gdt::setStr64Span(names, ksys::gdt::flag_PorchItem(), 0, num_entries);
+    ksys::gdt::setBoolSpan(equip_flags, ksys::gdt::flag_PorchItem_EquipFlag(), 0, num_entries);
+    ksys::gdt::setS32Span(values, ksys::gdt::flag_PorchItem_Value1(), 0, num_entries);
 }
 
 void PauseMenuDataMgr::cookItemGet(const ksys::CookItem& cook_item) {
@@ -1116,6 +1180,7 @@ void PauseMenuDataMgr::unequipAll(PouchItemType type) {
 KSYS_ALWAYS_INLINE inline void
 PauseMenuDataMgr::deleteItem_(const sead::OffsetList<PouchItem>& list, PouchItem* item,
                               const sead::SafeString& name) {
+    removeFromItemIndex(item);
     destroyAndRecycleItem(mItemLists, item);
     ksys::PlayReportMgr::instance()->reportDebug("PouchDelete", name);
     saveToGameData(list);
@@ -1203,6 +1268,7 @@ int PauseMenuDataMgr::getItemCount(const sead::SafeString& name, bool count_equi
     if (isPouchItemInvalid(type))
         return 0;
 
+    const auto lock = sead::makeScopedLock(mCritSection);
     const auto& items = getItems();
     sead::SafeString group_name;
     getSameGroupActorName(&group_name, name);
@@ -1242,23 +1308,23 @@ int PauseMenuDataMgr::getItemCount(const sead::SafeString& name, bool count_equi
         break;
     }
 
-    if (ksys::act::InfoData::instance()->hasTag(group_name.cstr(), ksys::act::tags::CanStack)) {
-        for (auto* item = first; item; item = items.next(item)) {
-            if (group_name == item->getName())
-                return item->getValue();
-        }
+    if (!first)
         return 0;
-    }
+
+    // Items are sorted by type, so items with this name can only be at or after `first`.
+    const auto& index = getItemIndex();
+    const auto* item = index.findFirst(group_name);
+
+    if (ksys::act::InfoData::instance()->hasTag(group_name.cstr(), ksys::act::tags::CanStack))
+        return item ? item->getValue() : 0;
 
     s32 count = 0;
     if (count_equipped) {
-        for (auto* item = first; item; item = items.next(item)) {
-            if (group_name == item->getName())
-                count += item->get25();
-        }
+        for (; item; item = index.findNext(item))
+            count += item->get25();
     } else {
-        for (auto* item = first; item; item = items.next(item)) {
-            if (group_name == item->getName() && item->get25())
+        for (; item; item = index.findNext(item)) {
+            if (item->get25())
                 count += !item->isEquipped();
         }
     }
@@ -1298,18 +1364,13 @@ const sead::SafeString& PauseMenuDataMgr::getDefaultEquipment(EquipmentSlot idx)
 
 bool PauseMenuDataMgr::hasItem(const sead::SafeString& name) const {
     const auto lock = sead::makeScopedLock(mCritSection);
-    bool ret = false;
-    for (auto& item : getItems()) {
-        if (name != item.getName())
-            continue;
+    const auto* item = getItemIndex().findFirst(name);
+    if (!item)
+        return false;
 
-        if (ksys::act::InfoData::instance()->hasTag(name.cstr(), ksys::act::tags::CanStack))
-            ret = item.getValue() > 0;
-        else
-            ret = true;
-        break;
-    }
-    return ret;
+    if (ksys::act::InfoData::instance()->hasTag(name.cstr(), ksys::act::tags::CanStack))
+        return item->getValue() > 0;
+    return true;
 }
 
 PouchItem* PauseMenuDataMgr::getMasterSword() const {
@@ -1330,8 +1391,10 @@ void PauseMenuDataMgr::removeGrabbedItems() {
     for (s32 i = 0, n = mGrabbedItems.size(); i < n; ++i) {
         auto& entry = mGrabbedItems[i];
         auto* item = entry.item;
-        if (item && item->getValue() == 0 && !entry._9)
+        if (item && item->getValue() == 0 && !entry._9) {
+            removeFromItemIndex(item);
             destroyAndRecycleItem(mItemLists, item);
+        }
         entry = {};
     }
 
@@ -1370,6 +1433,7 @@ bool PauseMenuDataMgr::addGrabbedItem(ksys::act::BaseProcLink* link) {
         if (entry.item->getValue() == 0 && !entry._9) {
             const auto lock = sead::makeScopedLock(cs);
             auto* item = entry.item;
+            removeFromItemIndex(item);
             destroyAndRecycleItem(mItemLists, item);
             updateInventoryInfo(items);
             updateListHeads();
@@ -1467,12 +1531,12 @@ void PauseMenuDataMgr::restoreMasterSword(bool only_if_broken) {
     }
 }
 
-static s32 checkItemRemoval(const sead::OffsetList<PouchItem>& items, const sead::SafeString& name,
+static s32 checkItemRemoval(const PouchItemIndex& index, const sead::SafeString& name,
                             int num_to_remove, bool include_equipped_items, bool stackable) {
     s32 total = 0;
-    for (const auto& item : items) {
-        if (name == item.getName() && (stackable || include_equipped_items || !item.isEquipped())) {
-            total += stackable ? item.getValue() : 1;
+    for (const auto* item = index.findFirst(name); item; item = index.findNext(item)) {
+        if (stackable || include_equipped_items || !item->isEquipped()) {
+            total += stackable ? item->getValue() : 1;
             if (total >= num_to_remove)
                 return true;
         }
@@ -1488,10 +1552,10 @@ bool PauseMenuDataMgr::checkAddOrRemoveItem(const sead::SafeString& name, int co
     if (count < 0) {
         const auto* info = ksys::act::InfoData::instance();
         const int num_to_remove = -count;
-        const auto& items = getItems();
+        const auto& index = getItemIndex();
         if (!info->hasTag(name.cstr(), ksys::act::tags::CanStack))
-            return checkItemRemoval(items, name, num_to_remove, include_equipped_items, false);
-        return checkItemRemoval(items, name, num_to_remove, true, true);
+            return checkItemRemoval(index, name, num_to_remove, include_equipped_items, false);
+        return checkItemRemoval(index, name, num_to_remove, true, true);
     }
 
     return !cannotGetItem(name, count);
@@ -1529,6 +1593,7 @@ void PauseMenuDataMgr::removeAllEnemyMaterials() {
     PouchItem* material_to_remove = nullptr;
     for (auto& item : items) {
         if (material_to_remove != nullptr) {
+            removeFromItemIndex(material_to_remove);
             getItems().erase(material_to_remove);
             destroyAndRecycleItem(material_to_remove);
         }
@@ -1538,8 +1603,10 @@ void PauseMenuDataMgr::removeAllEnemyMaterials() {
             info->hasTag(item.getName().cstr(), ksys::act::tags::EnemyMaterial) ? &item : nullptr;
     }
 
-    if (material_to_remove)
+    if (material_to_remove) {
+        removeFromItemIndex(material_to_remove);
         destroyAndRecycleItem(mItemLists, material_to_remove);
+    }
 
     saveToGameData(items);
     updateInventoryInfo(items);
@@ -1549,40 +1616,14 @@ void PauseMenuDataMgr::removeAllEnemyMaterials() {
 int PauseMenuDataMgr::countItemsWithProfile(const sead::SafeString& profile,
                                             bool count_stacked_items) const {
     const auto lock = sead::makeScopedLock(mCritSection);
-    s32 count = 0;
-    for (const auto& item : getItems()) {
-        const char* item_profile;
-        al::ByamlIter iter;
-        if (ksys::act::InfoData::instance()->getActorIter(&iter, item.getName().cstr()) &&
-            ksys::act::InfoData::instance()->getActorProfile(&item_profile, iter) &&
-            profile == item_profile) {
-            if (count_stacked_items &&
-                ksys::act::InfoData::instance()->hasTag(iter, ksys::act::tags::CanStack)) {
-                count += item.getValue();
-            } else {
-                count += 1;
-            }
-        }
-    }
-    return count;
+    auto& index = getItemIndex();
+    return index.countItems(index.getItemsWithProfile(profile), count_stacked_items);
 }
 
 int PauseMenuDataMgr::countItemsWithTag(u32 tag, bool count_stacked_items) const {
     const auto lock = sead::makeScopedLock(mCritSection);
-    s32 count = 0;
-    for (const auto& item : getItems()) {
-        al::ByamlIter iter;
-        if (ksys::act::InfoData::instance()->getActorIter(&iter, item.getName().cstr()) &&
-            ksys::act::InfoData::instance()->hasTag(iter, tag)) {
-            if (count_stacked_items &&
-                ksys::act::InfoData::instance()->hasTag(iter, ksys::act::tags::CanStack)) {
-                count += item.getValue();
-            } else {
-                count += 1;
-            }
-        }
-    }
-    return count;
+    auto& index = getItemIndex();
+    return index.countItems(index.getItemsWithTag(tag), count_stacked_items);
 }
 
 int PauseMenuDataMgr::countCookResults(const sead::SafeString& name, s32 effect_type,
@@ -1708,6 +1749,7 @@ void PauseMenuDataMgr::removeCookResult(const sead::SafeString& name, s32 effect
     if (!to_remove)
         return;
 
+    removeFromItemIndex(to_remove);
     destroyAndRecycleItem(mItemLists, to_remove);
     ksys::PlayReportMgr::instance()->reportDebug("PouchDeleteFromFlow", name);
     saveToGameData(items);
@@ -1781,6 +1823,7 @@ void PauseMenuDataMgr::initPouchForQuest() {
 
         for (auto& item : items) {
             if (to_remove != nullptr) {
+                removeFromItemIndex(to_remove);
                 getItems().erase(to_remove);
                 destroyAndRecycleItem(to_remove);
             }
@@ -1789,6 +1832,7 @@ void PauseMenuDataMgr::initPouchForQuest() {
         }
 
         if (to_remove) {
+            removeFromItemIndex(to_remove);
             getItems().erase(to_remove);
             destroyAndRecycleItem(to_remove);
         }
@@ -242,6 +242,8 @@ private:
 };
 KSYS_CHECK_SIZE_NX150(PouchItem, 0x298);
 
+class PouchItemIndex;
+
 // TODO
 class PauseMenuDataMgr {
     SEAD_SINGLETON_DISPOSER(PauseMenuDataMgr)
@@ -426,6 +428,11 @@ private:
         lists.destroyAndRecycleItem(item);
     }
 
+    /// Returns the name/tag/profile index for the item list, building it if necessary.
+    /// The index is not part of this object (see sItemIndex), so it can be updated from const
+    /// functions. mCritSection must be locked.
+    PouchItemIndex& getItemIndex() const;
+
     void resetItem();
 
     void resetItemAndPointers() {
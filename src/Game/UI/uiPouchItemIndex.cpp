@@ -0,0 +1,250 @@
+#include "Game/UI/uiPouchItemIndex.h"
+#include <codec/seadHashCRC32.h>
+#include "KingSystem/ActorSystem/actInfoCommon.h"
+#include "KingSystem/ActorSystem/actInfoData.h"
+
+namespace uking::ui {
+
+namespace {
+
+constexpr u32 BucketMask = PouchItemIndex::NumBuckets - 1;
+static_assert((PouchItemIndex::NumBuckets & BucketMask) == 0);
+
+u32 getBucketIdx(u32 name_hash) {
+    return (name_hash * 0x9e3779b9u) >> 16 & BucketMask;
+}
+
+}  // namespace
+
+void PouchItemIndex::SlotSet::clear() {
+    for (auto& word : mWords)
+        word = 0;
+}
+
+s32 PouchItemIndex::SlotSet::count() const {
+    s32 count = 0;
+    for (const u32 word : mWords)
+        count += __builtin_popcount(word);
+    return count;
+}
+
+void PouchItemIndex::build(const sead::OffsetList<PouchItem>& list, const PouchItem* buffer) {
+    for (auto& bucket : mBuckets)
+        bucket = NullSlot;
+    for (auto& slot : mSlots)
+        slot = {0, NullSlot, false, false, false, false};
+
+    mBuffer = buffer;
+    // Bumping the generation drops every cached query, so there is nothing to update here.
+    ++mGeneration;
+    mIsValid = true;
+    for (const auto& item : list)
+        addItem(&item);
+
+    ++mStats.num_builds;
+}
+
+void PouchItemIndex::addItem(const PouchItem* item) {
+    if (!mIsValid)
+        return;
+
+    const s32 idx = getSlot(item);
+    auto& slot = mSlots[idx];
+    slot.name_hash = sead::HashCRC32::calcStringHash(item->getName().cstr());
+    slot.in_list = true;
+    slot.actor_resolved = false;
+
+    const u32 bucket = getBucketIdx(slot.name_hash);
+    slot.next = mBuckets[bucket];
+    mBuckets[bucket] = s16(idx);
+
+    bool resolved = false;
+    const al::ByamlIter* actor = nullptr;
+    for (auto& query : mQueries) {
+        if (query.type == QueryType::Invalid || query.generation != mGeneration)
+            continue;
+        // Only look the actor up if there is a query that needs it.
+        if (!resolved) {
+            actor = resolveActor(idx);
+            resolved = true;
+        }
+        if (actor && matches(query, *actor))
+            query.slots.set(idx);
+    }
+}
+
+void PouchItemIndex::removeItem(const PouchItem* item) {
+    if (!mIsValid)
+        return;
+
+    const s32 idx = getSlot(item);
+    auto& slot = mSlots[idx];
+    if (!slot.in_list)
+        return;
+
+    s16* link = &mBuckets[getBucketIdx(slot.name_hash)];
+    while (*link != idx)
+        link = &mSlots[*link].next;
+    *link = slot.next;
+
+    slot = {0, NullSlot, false, false, false, false};
+    for (auto& query : mQueries)
+        query.slots.reset(idx);
+}
+
+const PouchItem* PouchItemIndex::findFirst(const sead::SafeString& name) const {
+    const u32 name_hash = sead::HashCRC32::calcStringHash(name.cstr());
+    for (s32 idx = mBuckets[getBucketIdx(name_hash)]; idx != NullSlot; idx = mSlots[idx].next) {
+        if (mSlots[idx].name_hash == name_hash && mBuffer[idx].getName() == name)
+            return &mBuffer[idx];
+    }
+    return nullptr;
+}
+
+const PouchItem* PouchItemIndex::findNext(const PouchItem* item) const {
+    const u32 name_hash = mSlots[getSlot(item)].name_hash;
+    for (s32 idx = mSlots[getSlot(item)].next; idx != NullSlot; idx = mSlots[idx].next) {
+        if (mSlots[idx].name_hash == name_hash && mBuffer[idx].getName() == item->getName())
+            return &mBuffer[idx];
+    }
+    return nullptr;
+}
+
+const al::ByamlIter* PouchItemIndex::resolveActor(s32 idx) {
+    auto& slot = mSlots[idx];
+    if (!slot.actor_resolved) {
+        auto* info = ksys::act::InfoData::instance();
+        // InfoData is keyed by the CRC32 of actor names, so the name hash can be reused.
+        slot.has_actor = info->getActorIter(&mActorIters[idx], slot.name_hash);
+        slot.can_stack =
+            slot.has_actor && info->hasTag(mActorIters[idx], ksys::act::tags::CanStack);
+        slot.actor_resolved = true;
+    }
+    return slot.has_actor ? &mActorIters[idx] : nullptr;
+}
+
+bool PouchItemIndex::matches(const Query& query, const al::ByamlIter& actor) {
+    auto* info = ksys::act::InfoData::instance();
+    switch (query.type) {
+    case QueryType::Tag:
+        return info->hasTag(actor, query.tag);
+    case QueryType::Profile: {
+        const char* profile;
+        return info->getActorProfile(&profile, actor) && query.profile == profile;
+    }
+    case QueryType::Invalid:
+        break;
+    }
+    return false;
+}
+
+PouchItemIndex::Query& PouchItemIndex::allocQuery() {
+    ++mStats.num_query_misses;
+    auto& query = mQueries[mNextQuery];
+    mNextQuery = (mNextQuery + 1) % NumCachedQueries;
+    query.generation = mGeneration;
+    query.slots.clear();
+    return query;
+}
+
+void PouchItemIndex::fillQuery(Query& query) {
+    for (s32 idx = 0; idx < NumSlots; ++idx) {
+        if (!mSlots[idx].in_list)
+            continue;
+        const auto* actor = resolveActor(idx);
+        if (actor && matches(query, *actor))
+            query.slots.set(idx);
+    }
+}
+
+const PouchItemIndex::SlotSet& PouchItemIndex::getItemsWithTag(u32 tag) {
+    for (const auto& query : mQueries) {
+        if (query.type == QueryType::Tag && query.generation == mGeneration && query.tag == tag) {
+            ++mStats.num_query_hits;
+            return query.slots;
+        }
+    }
+
+    auto& query = allocQuery();
+    query.type = QueryType::Tag;
+    query.tag = tag;
+    fillQuery(query);
+    return query.slots;
+}
+
+const PouchItemIndex::SlotSet&
+PouchItemIndex::getItemsWithProfile(const sead::SafeString& profile) {
+    for (const auto& query : mQueries) {
+        if (query.type == QueryType::Profile && query.generation == mGeneration &&
+            query.profile == profile) {
+            ++mStats.num_query_hits;
+            return query.slots;
+        }
+    }
+
+    auto& query = allocQuery();
+    query.type = QueryType::Profile;
+    query.profile = profile;
+    fillQuery(query);
+    return query.slots;
+}
+
+s32 PouchItemIndex::countItems(const SlotSet& slots, bool count_stacked_items) {
+    if (!count_stacked_items)
+        return slots.count();
+
+    s32 count = 0;
+    slots.forEach([&](s32 idx) {
+        // Every slot in a query result has already been resolved.
+        count += mSlots[idx].can_stack ? mBuffer[idx].getValue() : 1;
+    });
+    return count;
+}
+
+bool PouchItemIndex::checkConsistency(const sead::OffsetList<PouchItem>& list) const {
+    if (!mIsValid)
+        return true;
+
+    SlotSet listed;
+    s32 num_items = 0;
+    for (const auto& item : list) {
+        const s32 idx = getSlot(&item);
+        if (idx < 0 || idx >= NumSlots || !mSlots[idx].in_list)
+            return false;
+        if (mSlots[idx].name_hash != sead::HashCRC32::calcStringHash(item.getName().cstr()))
+            return false;
+        listed.set(idx);
+        ++num_items;
+    }
+
+    // Every bucket chain must only contain listed items.
+    s32 num_indexed_items = 0;
+    for (s32 bucket = 0; bucket < NumBuckets; ++bucket) {
+        for (s32 idx = mBuckets[bucket]; idx != NullSlot; idx = mSlots[idx].next) {
+            if (!listed.isSet(idx) || getBucketIdx(mSlots[idx].name_hash) != u32(bucket))
+                return false;
+            if (++num_indexed_items > num_items)
+                return false;
+        }
+    }
+    if (num_indexed_items != num_items)
+        return false;
+
+    // Cached queries must match a fresh lookup.
+    auto* info = ksys::act::InfoData::instance();
+    for (const auto& query : mQueries) {
+        if (query.type == QueryType::Invalid || query.generation != mGeneration)
+            continue;
+        for (s32 idx = 0; idx < NumSlots; ++idx) {
+            al::ByamlIter actor;
+            const bool expected = listed.isSet(idx) &&
+                                  info->getActorIter(&actor, mSlots[idx].name_hash) &&
+                                  matches(query, actor);
+            if (query.slots.isSet(idx) != expected)
+                return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace uking::ui
@@ -0,0 +1,139 @@
+#pragma once
+
+#include <basis/seadTypes.h>
+#include <container/seadOffsetList.h>
+#include <prim/seadSafeString.h>
+#include "Game/UI/uiPauseMenuDataMgr.h"
+#include "KingSystem/Utils/Byaml/Byaml.h"
+
+namespace uking::ui {
+
+/// Secondary index over the items in the PauseMenuDataMgr item buffer.
+///
+/// Items are identified by their slot in the buffer. The index maps name hashes to slots, and
+/// memoises which slots match an actor tag or profile so that tag and profile queries do not need
+/// to look up every item in InfoData again.
+///
+/// The index only depends on which items are in the list and their names, not on their order, so
+/// sorting the list does not affect it. It is kept up to date by calling addItem and removeItem
+/// whenever an item enters or leaves the list; cached tag and profile queries are updated in place.
+/// Values and equipped flags are modified in place in many places, so they are not indexed and must
+/// be read from the items themselves.
+class PouchItemIndex {
+public:
+    static constexpr s32 NumSlots = NumPouchItemsMax;
+    /// Must be a power of 2.
+    static constexpr s32 NumBuckets = 0x200;
+    static constexpr s32 NumCachedQueries = 16;
+
+    class SlotSet {
+    public:
+        void clear();
+        void set(s32 slot) { mWords[slot / 32] |= 1u << (slot % 32); }
+        void reset(s32 slot) { mWords[slot / 32] &= ~(1u << (slot % 32)); }
+        bool isSet(s32 slot) const { return mWords[slot / 32] & (1u << (slot % 32)); }
+        s32 count() const;
+
+        template <typename Function>
+        void forEach(const Function& fn) const;
+
+    private:
+        static constexpr s32 NumWords = (NumSlots + 31) / 32;
+        u32 mWords[NumWords]{};
+    };
+
+    struct Stats {
+        u32 num_builds;
+        u32 num_query_hits;
+        u32 num_query_misses;
+    };
+
+    /// Forces a full rebuild on the next access. Only needed if the list was modified in a way
+    /// that could not be reported with addItem or removeItem.
+    void invalidate() { mIsValid = false; }
+    bool isValid() const { return mIsValid; }
+    void build(const sead::OffsetList<PouchItem>& list, const PouchItem* buffer);
+
+    /// Must be called after `item` has been added to the list. Does nothing if the index is
+    /// invalid, as the next build will pick the item up anyway.
+    void addItem(const PouchItem* item);
+    /// Must be called before `item` is removed from the list and destroyed.
+    void removeItem(const PouchItem* item);
+
+    /// @return an item with the specified name, or nullptr.
+    /// Items with the same name are returned in no particular order.
+    const PouchItem* findFirst(const sead::SafeString& name) const;
+    /// @return the next item with the same name as `item`, or nullptr.
+    const PouchItem* findNext(const PouchItem* item) const;
+
+    /// @return the slots of all items whose actor has the specified tag.
+    const SlotSet& getItemsWithTag(u32 tag);
+    /// @return the slots of all items whose actor has the specified profile.
+    const SlotSet& getItemsWithProfile(const sead::SafeString& profile);
+
+    /// Counts the items in `slots`. Stackable items count as their value if count_stacked_items
+    /// is true, and as one item otherwise.
+    s32 countItems(const SlotSet& slots, bool count_stacked_items);
+
+    /// Checks the index against the item list. This is expensive and intended for debug builds.
+    /// @return whether the index matches the list.
+    bool checkConsistency(const sead::OffsetList<PouchItem>& list) const;
+
+    const Stats& getStats() const { return mStats; }
+
+private:
+    enum class QueryType : u8 {
+        Invalid,
+        Tag,
+        Profile,
+    };
+
+    struct Slot {
+        u32 name_hash;
+        /// Next slot in the same bucket.
+        s16 next;
+        bool in_list;
+        bool actor_resolved;
+        bool has_actor;
+        bool can_stack;
+    };
+
+    struct Query {
+        QueryType type = QueryType::Invalid;
+        u32 generation = 0;
+        u32 tag = 0;
+        sead::FixedSafeString<64> profile;
+        SlotSet slots;
+    };
+
+    static constexpr s16 NullSlot = -1;
+
+    s32 getSlot(const PouchItem* item) const { return s32(item - mBuffer); }
+    /// Looks up the actor of an item in InfoData, if that has not been done since it was added.
+    const al::ByamlIter* resolveActor(s32 slot);
+    static bool matches(const Query& query, const al::ByamlIter& actor);
+    Query& allocQuery();
+    void fillQuery(Query& query);
+
+    const PouchItem* mBuffer = nullptr;
+    bool mIsValid = false;
+    /// Incremented on every build so that memoised queries from older builds are ignored.
+    /// Queries from the current build are kept up to date by addItem and removeItem.
+    u32 mGeneration = 0;
+    u32 mNextQuery = 0;
+    s16 mBuckets[NumBuckets]{};
+    Slot mSlots[NumSlots]{};
+    al::ByamlIter mActorIters[NumSlots];
+    Query mQueries[NumCachedQueries];
+    Stats mStats{};
+};
+
+template <typename Function>
+inline void PouchItemIndex::SlotSet::forEach(const Function& fn) const {
+    for (s32 i = 0; i < NumWords; ++i) {
+        for (u32 word = mWords[i]; word != 0; word &= word - 1)
+            fn(i * 32 + __builtin_ctz(word));
+    }
+}
+
+}  // namespace uking::ui
@@ -1,9 +1,218 @@
 #include "KingSystem/ActorSystem/actActorLimiter.h"
+#include <cmath>
+#include <gfx/seadCamera.h>
+#include <hash/seadHashCRC32.h>
+#include <limits>
+#include <utility>
 #include "KingSystem/ActorSystem/actActorConstDataAccess.h"
+#include "KingSystem/ActorSystem/actActorSystem.h"
 #include "KingSystem/ActorSystem/actTag.h"
+#include "KingSystem/System/CameraMgr.h"
 
 namespace ksys::act {
 
+namespace {
+
+struct RecentEviction {
+    u32 name_hash;
+    u32 frame;
+};
+
+constexpr s32 NumRecentEvictions = 16;
+
+/// Eviction state for one category. Only allocated while the category has an eviction policy.
+struct PriorityState {
+    bool allocBuffers(s32 capacity, sead::Heap* heap) {
+        // Keep the ID table at most half full so that probe sequences stay short.
+        id_table_bits = 1;
+        while ((1 << id_table_bits) < 2 * capacity)
+            ++id_table_bits;
+        id_table_mask = (1u << id_table_bits) - 1;
+
+        return scores.tryAllocBuffer(capacity, heap) &&
+               touch_frames.tryAllocBuffer(capacity, heap) &&
+               heap_pos.tryAllocBuffer(capacity, heap) && nodes.tryAllocBuffer(capacity, heap) &&
+               free_nodes.tryAllocBuffer(capacity, heap) &&
+               proc_ids.tryAllocBuffer(capacity, heap) &&
+               id_table.tryAllocBuffer(s32(id_table_mask + 1), heap);
+    }
+
+    u32 getIdSlot(u32 id) const { return (id * 0x9e3779b1u) >> (32 - id_table_bits); }
+
+    /// @return the index of the node that holds the specified actor, or -1.
+    s32 findNode(u32 id) const {
+        for (u32 i = getIdSlot(id);; i = (i + 1) & id_table_mask) {
+            const s32 node_idx = id_table[i];
+            if (node_idx < 0 || proc_ids[node_idx] == id)
+                return node_idx;
+        }
+    }
+
+    void insertId(s32 node_idx, u32 id) {
+        proc_ids[node_idx] = id;
+        u32 i = getIdSlot(id);
+        while (id_table[i] >= 0)
+            i = (i + 1) & id_table_mask;
+        id_table[i] = node_idx;
+    }
+
+    void eraseId(s32 node_idx) {
+        u32 hole = getIdSlot(proc_ids[node_idx]);
+        while (id_table[hole] != node_idx)
+            hole = (hole + 1) & id_table_mask;
+
+        // Shift the following entries back instead of leaving a tombstone: an entry can fill
+        // the hole if the hole lies between its home slot and its current slot.
+        for (u32 i = (hole + 1) & id_table_mask; id_table[i] >= 0; i = (i + 1) & id_table_mask) {
+            const u32 home = getIdSlot(proc_ids[id_table[i]]);
+            if (((i - home) & id_table_mask) >= ((i - hole) & id_table_mask)) {
+                id_table[hole] = id_table[i];
+                hole = i;
+            }
+        }
+        id_table[hole] = -1;
+    }
+
+    void clearIds() {
+        for (auto& node_idx : id_table)
+            node_idx = -1;
+    }
+
+    /// Moves every node for which `is_free(node_idx)` returns true from the heap to the free
+    /// list, then restores the heap property.
+    template <typename Predicate>
+    void reclaimNodes(const Predicate& is_free) {
+        s32 num_kept = 0;
+        for (s32 i = 0; i < num_nodes; ++i) {
+            const s32 node_idx = nodes[i];
+            if (is_free(node_idx)) {
+                eraseId(node_idx);
+                heap_pos[node_idx] = -1;
+                free_nodes[num_free_nodes++] = node_idx;
+            } else {
+                nodes[num_kept] = node_idx;
+                heap_pos[node_idx] = num_kept;
+                ++num_kept;
+            }
+        }
+        num_nodes = num_kept;
+        heapify();
+    }
+
+    bool isLess(s32 a, s32 b) const { return scores[nodes[a]] < scores[nodes[b]]; }
+
+    void swapNodes(s32 a, s32 b) {
+        std::swap(nodes[a], nodes[b]);
+        heap_pos[nodes[a]] = a;
+        heap_pos[nodes[b]] = b;
+    }
+
+    void siftUp(s32 pos) {
+        while (pos > 0) {
+            const s32 parent = (pos - 1) / 2;
+            if (!isLess(pos, parent))
+                break;
+            swapNodes(pos, parent);
+            pos = parent;
+        }
+    }
+
+    void siftDown(s32 pos) {
+        while (true) {
+            const s32 left = 2 * pos + 1;
+            const s32 right = left + 1;
+            s32 smallest = pos;
+            if (left < num_nodes && isLess(left, smallest))
+                smallest = left;
+            if (right < num_nodes && isLess(right, smallest))
+                smallest = right;
+            if (smallest == pos)
+                break;
+            swapNodes(pos, smallest);
+            pos = smallest;
+        }
+    }
+
+    void push(s32 node_idx) {
+        nodes[num_nodes] = node_idx;
+        heap_pos[node_idx] = num_nodes;
+        ++num_nodes;
+        siftUp(num_nodes - 1);
+    }
+
+    s32 popMin() {
+        if (num_nodes == 0)
+            return -1;
+        const s32 node_idx = nodes[0];
+        swapNodes(0, --num_nodes);
+        heap_pos[node_idx] = -1;
+        siftDown(0);
+        return node_idx;
+    }
+
+    void heapify() {
+        for (s32 i = num_nodes / 2 - 1; i >= 0; --i)
+            siftDown(i);
+    }
+
+    ActorLimiter::EvictionPolicy* policy = nullptr;
+    /// Retention score for each node.
+    sead::Buffer<f32> scores;
+    /// Frame in which each node's actor was added or last touched.
+    sead::Buffer<u32> touch_frames;
+    /// Position of each node in the heap, or -1.
+    sead::Buffer<s32> heap_pos;
+    /// Indices of occupied nodes, as a min-heap ordered by score.
+    sead::Buffer<s32> nodes;
+    s32 num_nodes = 0;
+    /// Indices of nodes that are not in the heap.
+    sead::Buffer<s32> free_nodes;
+    s32 num_free_nodes = 0;
+    /// Proc ID of the actor in each node that is in the heap.
+    sead::Buffer<u32> proc_ids;
+    /// Maps proc IDs to node indices (open addressing with linear probing; -1 for empty slots).
+    sead::Buffer<s32> id_table;
+    s32 id_table_bits = 0;
+    u32 id_table_mask = 0;
+};
+
+struct CategoryStats {
+    ActorLimiter::Stats stats{};
+    RecentEviction recent_evictions[NumRecentEvictions]{};
+    s32 next_recent_eviction = 0;
+};
+
+PriorityState sPriority[ActorLimiter::NumCategories];
+CategoryStats sStats[ActorLimiter::NumCategories];
+sead::Heap* sHeap = nullptr;
+/// Starts at 1 so that zero-initialised eviction records are never considered recent.
+u32 sFrame = 1;
+
+constexpr f32 MaxScore = std::numeric_limits<f32>::infinity();
+
+/// Used for the categories that tend to fill up during fights (see ActorLimiter::init).
+ActorLimiter::DefaultEvictionPolicy sDefaultPolicy;
+
+void recordAdd(s32 category, const BaseProc* proc) {
+    auto& stats = sStats[category];
+    ++stats.stats.num_added;
+
+    const u32 name_hash = sead::HashCRC32::calcStringHash(proc->getName());
+    for (const auto& eviction : stats.recent_evictions) {
+        if (eviction.name_hash == name_hash && eviction.frame != 0 &&
+            sFrame - eviction.frame <= ActorLimiter::RespawnWindowFrames) {
+            ++stats.stats.num_respawns;
+            break;
+        }
+    }
+}
+
+}  // namespace
+
+s32 ActorLimiter::List::getCategoryIdx() const {
+    return s32(this - &ActorLimiter::instance()->mLists.ref()[0]);
+}
+
 bool ActorLimiter::List::init(sead::Heap* heap, int capacity) {
     mNodes.allocBufferAssert(capacity, heap);
     if (!mNodes.isBufferReady())
@@ -15,9 +224,26 @@ bool ActorLimiter::List::init(sead::Heap* heap, int capacity) {
     return true;
 }
 
+void ActorLimiter::List::evict(ActorConstDataAccess& acc, s32 category) {
+    if (acc.hasProc()) {
+        auto& stats = sStats[category];
+        ++stats.stats.num_evicted;
+        auto& eviction = stats.recent_evictions[stats.next_recent_eviction];
+        eviction.name_hash = sead::HashCRC32::calcStringHash(acc.getName());
+        eviction.frame = sFrame;
+        stats.next_recent_eviction = (stats.next_recent_eviction + 1) % NumRecentEvictions;
+    }
+
+    acc.deleteEx(BaseProc::DeleteReason::_f);
+}
+
 bool ActorLimiter::List::addActor(BaseProc* proc, bool allow_evicting_old_actors) {
     const auto lock = sead::makeScopedLock(mCritSection);
 
+    const s32 category = getCategoryIdx();
+    if (sPriority[category].policy)
+        return addActorByPriority(proc, allow_evicting_old_actors, category);
+
     // Find a free node.
     Node* target_node = nullptr;
     for (auto& node : mActorList) {
@@ -30,8 +256,10 @@ bool ActorLimiter::List::addActor(BaseProc* proc, bool allow_evicting_old_actors
     }
 
     if (target_node == nullptr) {
-        if (!allow_evicting_old_actors)
+        if (!allow_evicting_old_actors) {
+            ++sStats[category].stats.num_rejected;
             return false;
+        }
 
         target_node = mActorList.popFront();
         if (target_node) {
@@ -46,26 +274,203 @@ bool ActorLimiter::List::addActor(BaseProc* proc, bool allow_evicting_old_actors
                     acquireActor(&target_node->proc_link, &acc);
             }
 
-            acc.deleteEx(BaseProc::DeleteReason::_f);
+            evict(acc, category);
         }
 
-        if (target_node == nullptr)
+        if (target_node == nullptr) {
+            ++sStats[category].stats.num_rejected;
             return false;
+        }
     }
 
     target_node->proc_link.acquire(proc, false);
     mActorList.pushBack(target_node);
+    recordAdd(category, proc);
+    return true;
+}
+
+bool ActorLimiter::List::addActorByPriority(BaseProc* proc, bool allow_evicting_old_actors,
+                                            s32 category) {
+    auto& state = sPriority[category];
+
+    // Nodes whose actor is gone are only moved to the free list by calc, so look for them
+    // before evicting an actor that is still alive.
+    if (state.num_free_nodes == 0)
+        state.reclaimNodes([&](s32 idx) { return !mNodes[idx].proc_link.hasProc(); });
+
+    s32 node_idx = -1;
+    if (state.num_free_nodes != 0) {
+        node_idx = state.free_nodes[--state.num_free_nodes];
+    } else {
+        if (!allow_evicting_old_actors) {
+            ++sStats[category].stats.num_rejected;
+            return false;
+        }
+
+        node_idx = state.popMin();
+        if (node_idx < 0) {
+            ++sStats[category].stats.num_rejected;
+            return false;
+        }
+
+        ActorConstDataAccess acc;
+        acquireActor(&mNodes[node_idx].proc_link, &acc);
+
+        // Priority material actors will not be evicted if possible.
+        if (acc.hasTag(tags::PriorityMaterial) && state.num_nodes != 0) {
+            const s32 kept_node_idx = node_idx;
+            node_idx = state.popMin();
+            state.push(kept_node_idx);
+            acquireActor(&mNodes[node_idx].proc_link, &acc);
+        }
+
+        state.eraseId(node_idx);
+        evict(acc, category);
+    }
+
+    mNodes[node_idx].proc_link.acquire(proc, false);
+    state.insertId(node_idx, proc->getId());
+    state.touch_frames[node_idx] = sFrame;
+    // The actor is not fully initialised yet, so it can only be scored on the next update.
+    // Until then, it is protected from eviction.
+    state.scores[node_idx] = MaxScore;
+    state.push(node_idx);
+    recordAdd(category, proc);
     return true;
 }
 
+f32 ActorLimiter::DefaultEvictionPolicy::calcRetentionScore(const ActorConstDataAccess& actor,
+                                                             u32 last_touch_frame,
+                                                             const Context& context) const {
+    // Actors within ~60 degrees of the camera direction are treated as on screen.
+    constexpr f32 OnScreenCosSq = 0.25f;
+
+    const sead::Vector3f& pos = actor.getPreviousPos();
+
+    const sead::Vector3f to_player = pos - context.player_pos;
+    f32 score = -mWeights.distance * to_player.length();
+
+    const sead::Vector3f to_actor = pos - context.camera_pos;
+    const f32 along = to_actor.x * context.camera_dir.x + to_actor.y * context.camera_dir.y +
+                      to_actor.z * context.camera_dir.z;
+    if (along > 0.0f && along * along >= OnScreenCosSq * to_actor.squaredLength())
+        score += mWeights.on_screen;
+
+    score -= mWeights.idle * f32(context.frame - last_touch_frame);
+    return score;
+}
+
 SEAD_SINGLETON_DISPOSER_IMPL(ActorLimiter)
 
 bool ActorLimiter::init(sead::Heap* heap, const sead::SafeArray<int, NumCategories>& capacities) {
+    sHeap = heap;
     for (s32 i = 0; i < NumCategories; ++i) {
         if (!mLists.ref()[i].init(heap, capacities[i]))
             return false;
     }
+
+    // Drops are what fills up in crowded fights, and FIFO eviction makes them disappear right
+    // in front of the player. The other categories keep FIFO eviction.
+    setEvictionPolicy(Category::DroppedItems, &sDefaultPolicy);
+    setEvictionPolicy(Category::Drops, &sDefaultPolicy);
+    return true;
+}
+
+bool ActorLimiter::setEvictionPolicy(Category category, EvictionPolicy* policy) {
+    auto& list = get(category);
+    auto& state = sPriority[s32(category)];
+    const auto lock = sead::makeScopedLock(list.mCritSection);
+
+    if (!policy) {
+        // The FIFO list still contains every node, so nothing needs to be converted back.
+        state.policy = nullptr;
+        return true;
+    }
+
+    const s32 capacity = list.mNodes.size();
+    if (!state.scores.isBufferReady() && !state.allocBuffers(capacity, sHeap))
+        return false;
+
+    state.num_nodes = 0;
+    state.num_free_nodes = 0;
+    state.clearIds();
+    for (s32 i = 0; i < capacity; ++i) {
+        state.heap_pos[i] = -1;
+        ActorConstDataAccess acc;
+        if (!acquireActor(&list.mNodes[i].proc_link, &acc)) {
+            state.free_nodes[state.num_free_nodes++] = i;
+            continue;
+        }
+        state.scores[i] = MaxScore;
+        state.touch_frames[i] = sFrame;
+        state.insertId(i, acc.getId());
+        state.push(i);
+    }
+
+    state.policy = policy;
     return true;
 }
 
+void ActorLimiter::touchActor(Category category, BaseProc* proc) {
+    auto& list = get(category);
+    auto& state = sPriority[s32(category)];
+    const auto lock = sead::makeScopedLock(list.mCritSection);
+
+    if (!state.policy)
+        return;
+
+    const s32 node_idx = state.findNode(proc->getId());
+    if (node_idx >= 0)
+        state.touch_frames[node_idx] = sFrame;
+}
+
+void ActorLimiter::calc() {
+    ++sFrame;
+
+    EvictionPolicy::Context context;
+    context.player_pos = sead::Vector3f::zero;
+    context.camera_pos = sead::Vector3f::zero;
+    context.camera_dir = sead::Vector3f::ez;
+    context.frame = sFrame;
+    if (auto* actor_system = ActorSystem::instance())
+        context.player_pos = actor_system->getPlayerPos();
+    if (auto* camera_mgr = CameraMgr::instance()) {
+        if (auto* camera = camera_mgr->getLookAtCamera()) {
+            context.camera_pos = camera->getPos();
+            const sead::Vector3f dir = camera->getAt() - camera->getPos();
+            const f32 length = dir.length();
+            if (length > 0.0f)
+                context.camera_dir = dir * (1.0f / length);
+        }
+    }
+
+    for (s32 category = 0; category < NumCategories; ++category) {
+        auto& state = sPriority[category];
+        if (!state.policy)
+            continue;
+
+        auto& list = mLists.ref()[category];
+        const auto lock = sead::makeScopedLock(list.mCritSection);
+
+        // Nodes whose actor is gone are moved to the free list so that they are reused first.
+        state.reclaimNodes([&](s32 node_idx) {
+            ActorConstDataAccess acc;
+            if (!acquireActor(&list.mNodes[node_idx].proc_link, &acc))
+                return true;
+            state.scores[node_idx] =
+                state.policy->calcRetentionScore(acc, state.touch_frames[node_idx], context);
+            return false;
+        });
+    }
+}
+
+const ActorLimiter::Stats& ActorLimiter::getStats(Category category) const {
+    return sStats[s32(category)].stats;
+}
+
+void ActorLimiter::resetStats() {
+    for (auto& stats : sStats)
+        stats = {};
+}
+
 }  // namespace ksys::act
@@ -4,6 +4,7 @@
 #include <container/seadOffsetList.h>
 #include <container/seadSafeArray.h>
 #include <heap/seadDisposer.h>
+#include <math/seadVector.h>
 #include <prim/seadStorageFor.h>
 #include <thread/seadCriticalSection.h>
 #include "KingSystem/ActorSystem/actBaseProcLink.h"
@@ -11,6 +12,8 @@
 
 namespace ksys::act {
 
+class ActorConstDataAccess;
+
 class ActorLimiter {
     SEAD_SINGLETON_DISPOSER(ActorLimiter)
     ActorLimiter() = default;
@@ -28,6 +31,56 @@ public:
         _7 = 7,
     };
     static constexpr int NumCategories = 8;
+    /// An actor that is added within this many frames after an actor with the same name was
+    /// evicted from the same category counts as a respawn.
+    static constexpr u32 RespawnWindowFrames = 300;
+
+    struct Stats {
+        u32 num_added;
+        u32 num_evicted;
+        /// Number of actors that could not be added because the list was full.
+        u32 num_rejected;
+        u32 num_respawns;
+    };
+
+    /// Decides which actor is evicted when a list is full.
+    /// Actors with the lowest retention score are evicted first.
+    class EvictionPolicy {
+    public:
+        struct Context {
+            sead::Vector3f player_pos;
+            sead::Vector3f camera_pos;
+            /// Normalized.
+            sead::Vector3f camera_dir;
+            u32 frame;
+        };
+
+        virtual ~EvictionPolicy() = default;
+        /// @param last_touch_frame The frame in which the actor was added or last touched.
+        virtual f32 calcRetentionScore(const ActorConstDataAccess& actor, u32 last_touch_frame,
+                                       const Context& context) const = 0;
+    };
+
+    /// Keeps actors that are close to the player, in front of the camera or recently touched.
+    class DefaultEvictionPolicy : public EvictionPolicy {
+    public:
+        struct Weights {
+            /// Score lost per unit of distance to the player.
+            f32 distance = 1.0;
+            f32 on_screen = 100.0;
+            /// Score lost per frame since the actor was last touched.
+            f32 idle = 0.05;
+        };
+
+        DefaultEvictionPolicy() = default;
+        explicit DefaultEvictionPolicy(const Weights& weights) : mWeights(weights) {}
+
+        f32 calcRetentionScore(const ActorConstDataAccess& actor, u32 last_touch_frame,
+                               const Context& context) const override;
+
+    private:
+        Weights mWeights;
+    };
 
     class List {
     public:
@@ -38,11 +91,17 @@ public:
         bool addActor(BaseProc* proc, bool allow_evicting_old_actors);
 
     private:
+        friend class ActorLimiter;
+
         struct Node {
             sead::ListNode node;
             BaseProcLink proc_link;
         };
 
+        s32 getCategoryIdx() const;
+        bool addActorByPriority(BaseProc* proc, bool allow_evicting_old_actors, s32 category);
+        void evict(ActorConstDataAccess& acc, s32 category);
+
         sead::Buffer<Node> mNodes;
         sead::OffsetList<Node> mActorList;
         sead::CriticalSection mCritSection;
@@ -54,6 +113,20 @@ public:
     List& get(Category category) { return mLists.ref()[s32(category)]; }
     const List& get(Category category) const { return mLists.ref()[s32(category)]; }
 
+    /// Evicts actors in order of their retention score instead of in FIFO order.
+    /// Passing nullptr restores FIFO eviction. The policy must outlive the limiter.
+    bool setEvictionPolicy(Category category, EvictionPolicy* policy);
+
+    /// Marks an actor as recently interacted with, for policies that take this into account.
+    void touchActor(Category category, BaseProc* proc);
+
+    /// Advances the frame counter and recomputes the retention scores for categories
+    /// that use an eviction policy. Must be called once per frame.
+    void calc();
+
+    const Stats& getStats(Category category) const;
+    void resetStats();
+
 private:
     sead::StorageFor<sead::SafeArray<List, NumCategories>> mLists{sead::ZeroInitializeTag{}};
 };
@@ -2,6 +2,7 @@
 #include <prim/seadScopedLock.h>
 #include "KingSystem/ActorSystem/actASSetting.h"
 #include "KingSystem/ActorSystem/actActorParam.h"
+#include "KingSystem/Resource/Actor/resAIProgramImage.h"
 #include "KingSystem/Resource/Actor/resResourceAIProgram.h"
 #include "KingSystem/Resource/Actor/resResourceAISchedule.h"
 #include "KingSystem/Resource/Actor/resResourceAS.h"
@@ -31,6 +32,7 @@
 #include "KingSystem/Resource/resResourceMgrTask.h"
 #include "KingSystem/Resource/resSystem.h"
 #include "KingSystem/Resource/resTempResourceLoader.h"
+#include "KingSystem/System/MemoryProfiler.h"
 #include "KingSystem/Utils/Debug.h"
 #include "KingSystem/Utils/HeapUtil.h"
 #include "KingSystem/Utils/ParamIO.h"
@@ -48,10 +50,15 @@ void ActorParamMgr::init(sead::Heap* heap, sead::Heap* debug_heap) {
     mTempHeap = util::DualHeap::create(0x300000, "TmpActorParamMgr", heap, debug_heap,
                                        sizeof(void*), sead::Heap::cHeapDirection_Forward, false);
     mTempHeap->enableLock(true);
+    if (auto* profiler = MemoryProfiler::instance())
+        profiler->trackHeap(mTempHeap, MemoryProfiler::HeapType::DualHeap);
     mDebugHeap = debug_heap;
 
     mParams = new (mTempHeap) ActorParam[NumParams];
 
+    res::AIProgramImageCache::createInstance(heap);
+    res::AIProgramImageCache::instance()->init(heap, 0x100000);
+
     res::registerEntryFactory(new (mTempHeap) res::EntryFactory<res::ActorLink>(1.0, 0x1000),
                               "bxml");
     res::registerEntryFactory(new (mTempHeap) res::EntryFactory<res::GParamList>(
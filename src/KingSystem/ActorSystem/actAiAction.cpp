@@ -1,17 +1,38 @@
 #include "KingSystem/ActorSystem/actAiAction.h"
 #include <codec/seadHashCRC32.h>
+#include <time/seadTickTime.h>
 #include "KingSystem/ActorSystem/actActor.h"
 #include "KingSystem/ActorSystem/actActorParam.h"
+#include "KingSystem/ActorSystem/actAiActionProfiler.h"
 #include "KingSystem/ActorSystem/actAiRoot.h"
+#include "KingSystem/ActorSystem/actAiTrace.h"
 #include "KingSystem/ActorSystem/actionDummyAction.h"
 #include "KingSystem/Resource/Actor/resResourceAIProgram.h"
+#include "KingSystem/Utils/Container/PerfectHashTable.h"
 
 namespace ksys::act::ai {
 
+namespace {
+/// Maps name hashes to indices in Actions::sFactories.
+util::PerfectHashTable<0x800> sFactoryIndex;
+}  // namespace
+
 Action::Action(const InitArg& arg) : ActionBase(arg) {}
 
 void Action::calc() {
+    // Bitwise or: a single branch when instrumentation is off.
+    if (!(ActionCalcProfiler::isEnabled() | Trace::isEnabled())) {
+        calc_();
+        return;
+    }
+
+    const sead::TickTime start;
     calc_();
+    const u64 ticks = sead::TickTime().diff(start).toTicks();
+    if (ActionCalcProfiler::isEnabled())
+        ActionCalcProfiler::record(getRuntimeTypeInfo(), getClassName(), ticks);
+    if (Trace::isEnabled())
+        Trace::recordCalc(this, ticks);
 }
 
 Actions::Actions() = default;
@@ -148,6 +169,11 @@ void Actions::onPreDelete() const {
 
 ActionFactory* Actions::getFactory(const sead::SafeString& name) {
     const u32 name_hash = sead::HashCRC32::calcStringHash(name);
+    if (sFactoryIndex.isValid()) {
+        ActionFactory* factory = sFactories.get(sFactoryIndex.find(name_hash));
+        return factory->hash == name_hash ? factory : nullptr;
+    }
+
     const s32 idx = sFactories.binarySearch(
         name_hash, +[](const ActionFactory& factory, const u32& hash) {
             if (factory.hash < hash)
@@ -163,6 +189,7 @@ ActionFactory* Actions::getFactory(const sead::SafeString& name) {
 
 void Actions::setFactories(int count, ActionFactory* factories) {
     sFactories.setBuffer(count, factories);
+    sFactoryIndex.build(count, [factories](s32 i) { return factories[i].hash; });
 }
 
 sead::Buffer<ActionFactory> Actions::sFactories;
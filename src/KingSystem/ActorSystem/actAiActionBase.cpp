@@ -4,6 +4,7 @@
 #include "KingSystem/ActorSystem/actAiAction.h"
 #include "KingSystem/ActorSystem/actAiInlineParam.h"
 #include "KingSystem/ActorSystem/actAiRoot.h"
+#include "KingSystem/ActorSystem/actAiTrace.h"
 #include "KingSystem/Resource/Actor/resResourceAIProgram.h"
 #include "KingSystem/Utils/InitTimeInfo.h"
 #include "KingSystem/Utils/Thread/MessageTransceiverId.h"
@@ -89,6 +90,9 @@ void ActionBase::enter(InlineParamPack* params, const sead::SafeString& context)
         mActor->onAiEnter(getName(), context.cstr());
     }
 
+    if (Trace::isEnabled())
+        Trace::recordEnter(this);
+
     resetFlags();
     if (params)
         params->copyToParamPack(mParams);
@@ -120,8 +124,10 @@ void ActionBase::updateBehaviorsOnEnter() {
     }
 
     auto* root = mActor->getRootAi();
-    for (auto indice : *indices)
-        root->setBehavior(root->getBehaviors().getClasses()[indice]);
+    for (auto indice : *indices) {
+        if (auto* behavior = root->mBehaviors.activate(mActor, indice))
+            root->setBehavior(behavior);
+    }
 }
 
 bool ActionBase::takeOver(ActionBase* src, const sead::SafeString& context) {
@@ -170,6 +176,9 @@ void ActionBase::leave() {
     if (auto* child = getCurrentChild())
         child->leave();
 
+    if (Trace::isEnabled())
+        Trace::recordLeave(this);
+
     updateBehaviorsOnLeave();
     leave_();
     postLeave();
@@ -201,8 +210,11 @@ void ActionBase::updateBehaviorsOnLeave() {
     }
 
     auto* root = mActor->getRootAi();
-    for (auto indice : *indices)
-        root->resetBehavior(root->getBehaviors().getClasses()[indice]);
+    for (auto indice : *indices) {
+        // Behaviors that were never activated do not need to be reset.
+        if (auto* behavior = root->getBehaviors().getBehavior(indice))
+            root->resetBehavior(behavior);
+    }
 }
 
 bool ActionBase::oneShot(InlineParamPack* params) {
@@ -287,6 +299,18 @@ template bool ActionBase::getStaticParam(const float**, const sead::SafeString&)
 template bool ActionBase::getStaticParam(const sead::Vector3f**, const sead::SafeString&) const;
 template bool ActionBase::getStaticParam(const bool**, const sead::SafeString&) const;
 
+template <typename T>
+bool ActionBase::getStaticParam(T* value, StaticParamSlot* slot) const {
+    return getAIProg()->getSInstParam(value, getDef(), slot);
+}
+
+template bool ActionBase::getStaticParam(const char**, StaticParamSlot*) const;
+template bool ActionBase::getStaticParam(sead::SafeString*, StaticParamSlot*) const;
+template bool ActionBase::getStaticParam(const int**, StaticParamSlot*) const;
+template bool ActionBase::getStaticParam(const float**, StaticParamSlot*) const;
+template bool ActionBase::getStaticParam(const sead::Vector3f**, StaticParamSlot*) const;
+template bool ActionBase::getStaticParam(const bool**, StaticParamSlot*) const;
+
 void ActionBase::logMissingParam(const sead::SafeString& param) const {
     // Stubbed in release versions
     const auto type = getType();
@@ -163,6 +163,9 @@ protected:
 
     template <typename T>
     bool getStaticParam(T* value, const sead::SafeString& key) const;
+    /// Faster version for generated code: the key is pre-hashed and its index is cached.
+    template <typename T>
+    bool getStaticParam(T* value, StaticParamSlot* slot) const;
 
     void logMissingParam(const sead::SafeString& param) const;
 
@@ -172,13 +175,14 @@ protected:
     template <typename T>
     bool getAITreeVariable(T** value, const sead::SafeString& key) const;
 
+    /// The key is hashed once by the caller and the hash is reused at every level.
     template <typename T>
-    bool getDynamicParamImpl(T* value, const sead::SafeString& key,
-                             bool (ParamPack::*getter)(T* value, const sead::SafeString& key) const,
+    bool getDynamicParamImpl(T* value, const sead::SafeString& key, u32 hash,
+                             bool (ParamPack::*getter)(T* value, u32 hash) const,
                              T* default_value) const {
         auto* action = this;
         while (action && action->mFlags.isOff(Flag::_80)) {
-            if ((action->mParams.*getter)(value, key))
+            if ((action->mParams.*getter)(value, hash))
                 return true;
             if (action->mFlags.isOff(Flag::DynamicParamChild))
                 goto fail;
@@ -189,7 +193,7 @@ protected:
 
         for (s32 i = 0, n = action->getNumChildren(); i < n; ++i) {
             auto* child = action->getChild(i);
-            if (child->getDynamicParamImpl<T>(value, key, getter, default_value))
+            if (child->getDynamicParamImpl<T>(value, key, hash, getter, default_value))
                 return true;
         }
 
@@ -201,11 +205,13 @@ protected:
 
     template <AIDefParamType Type, typename T>
     bool getDynamicParamPtrImpl(T** value, const sead::SafeString& key, T* default_value) const {
-        return getDynamicParamImpl(value, key, &ParamPack::getPtrGeneric<T, Type>, &default_value);
+        return getDynamicParamImpl(value, key, ParamPack::calcHash(key),
+                                   &ParamPack::getPtrGeneric<T, Type>, &default_value);
     }
 
     bool getDynamicParam(sead::SafeString* value, const sead::SafeString& key) const {
-        return getDynamicParamImpl(value, key, &ParamPack::getString, getDefaultString());
+        return getDynamicParamImpl(value, key, ParamPack::calcHash(key),
+                                   &ParamPack::getStringByHash, getDefaultString());
     }
 
     bool getDynamicParam(int** value, const sead::SafeString& key) const {
@@ -251,7 +257,8 @@ protected:
     // TODO: rename -- why do these exist?
     template <AIDefParamType Type, typename T>
     bool getDynamicParamPtrImpl2(T** value, const sead::SafeString& key, T* default_value) const {
-        return getDynamicParamImpl(value, key, &ParamPack::getPtrGeneric2<T, Type>, &default_value);
+        return getDynamicParamImpl(value, key, ParamPack::calcHash(key),
+                                   &ParamPack::getPtrGeneric2<T, Type>, &default_value);
     }
 
     bool getDynamicParam2(int** value, const sead::SafeString& key) const {
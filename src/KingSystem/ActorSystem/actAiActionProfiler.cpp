@@ -0,0 +1,88 @@
+#include "KingSystem/ActorSystem/actAiActionProfiler.h"
+#include <algorithm>
+#include <thread/seadAtomic.h>
+
+namespace ksys::act::ai {
+
+namespace {
+
+struct TypeEntry {
+    sead::Atomic<const void*> key;
+    const char* name;
+    sead::Atomic<u64> total_ticks;
+    sead::Atomic<u32> num_calls;
+};
+
+TypeEntry sTypes[ActionCalcProfiler::MaxTypes]{};
+
+TypeEntry* findOrAddType(const void* key, const char* name) {
+    static_assert((ActionCalcProfiler::MaxTypes & (ActionCalcProfiler::MaxTypes - 1)) == 0);
+    constexpr u32 Mask = ActionCalcProfiler::MaxTypes - 1;
+
+    u32 idx = u32((uintptr_t(key) >> 4) * 0x9e3779b9u) & Mask;
+    for (s32 i = 0; i < ActionCalcProfiler::MaxTypes; ++i, idx = (idx + 1) & Mask) {
+        auto& entry = sTypes[idx];
+        const void* entry_key = entry.key;
+        if (entry_key == key)
+            return &entry;
+
+        if (entry_key == nullptr) {
+            // Other threads may briefly see the entry without a name; getRanking skips those.
+            if (entry.key.compareExchange(nullptr, key)) {
+                entry.name = name;
+                return &entry;
+            }
+            if (entry.key == key)
+                return &entry;
+        }
+    }
+    return nullptr;
+}
+
+}  // namespace
+
+bool ActionCalcProfiler::sEnabled = false;
+
+void ActionCalcProfiler::record(const void* key, const char* name, u64 ticks) {
+    TypeEntry* entry = findOrAddType(key, name);
+    if (!entry)
+        return;
+    entry->num_calls.increment();
+    entry->total_ticks.fetchAdd(ticks);
+}
+
+s32 ActionCalcProfiler::getRanking(Entry* entries, s32 max_entries) {
+    s32 num_entries = 0;
+    for (auto& type : sTypes) {
+        if (!type.key || !type.name)
+            continue;
+
+        const Entry entry{type.name, type.total_ticks, type.num_calls};
+        const auto compare = [](const Entry& lhs, const Entry& rhs) {
+            return lhs.total_ticks > rhs.total_ticks;
+        };
+
+        // Keep the array sorted and only retain the max_entries most expensive types.
+        if (num_entries == max_entries) {
+            if (max_entries == 0 || !compare(entry, entries[num_entries - 1]))
+                continue;
+            --num_entries;
+        }
+        Entry* it = std::upper_bound(entries, entries + num_entries, entry, compare);
+        std::move_backward(it, entries + num_entries, entries + num_entries + 1);
+        *it = entry;
+        ++num_entries;
+    }
+    return num_entries;
+}
+
+void ActionCalcProfiler::reset() {
+    for (auto& type : sTypes) {
+        type.total_ticks.store(0);
+        type.num_calls.store(0);
+        type.name = nullptr;
+        type.key.store(nullptr);
+    }
+}
+
+}  // namespace ksys::act::ai
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <basis/seadTypes.h>
+
+namespace ksys::act::ai {
+
+/// Accumulates time spent in action calc, per action type.
+///
+/// When enabled, every Action::calc() call is timed and attributed to the C++ type of the
+/// action. The ranking is meant to identify which action types are the most expensive to update.
+class ActionCalcProfiler {
+public:
+    static constexpr s32 MaxTypes = 0x800;
+
+    struct Entry {
+        const char* name;
+        u64 total_ticks;
+        u32 num_calls;
+    };
+
+    static void setEnabled(bool enabled) { sEnabled = enabled; }
+    static bool isEnabled() { return sEnabled; }
+
+    /// Thread-safe.
+    /// @param key A pointer that uniquely identifies the action type (e.g. its RTTI).
+    static void record(const void* key, const char* name, u64 ticks);
+
+    /// Fills `entries` with the most expensive action types, sorted by total calc time.
+    /// @return the number of entries that were written.
+    static s32 getRanking(Entry* entries, s32 max_entries);
+
+    /// Clears all entries. Must not be called while actions are being updated.
+    static void reset();
+
+private:
+    static bool sEnabled;
+};
+
+}  // namespace ksys::act::ai
@@ -1,4 +1,5 @@
 #include "KingSystem/ActorSystem/actAiAi.h"
+#include <time/seadTickTime.h>
 #include "KingSystem/ActorSystem/actActor.h"
 #include "KingSystem/ActorSystem/actActorParam.h"
 #include "KingSystem/ActorSystem/actActorUtil.h"
@@ -6,11 +7,18 @@
 #include "KingSystem/ActorSystem/actAiClassDef.h"
 #include "KingSystem/ActorSystem/actAiInlineParam.h"
 #include "KingSystem/ActorSystem/actAiRoot.h"
+#include "KingSystem/ActorSystem/actAiTrace.h"
 #include "KingSystem/ActorSystem/aiDummyAi.h"
 #include "KingSystem/Resource/Actor/resResourceAIProgram.h"
+#include "KingSystem/Utils/Container/PerfectHashTable.h"
 
 namespace ksys::act::ai {
 
+namespace {
+/// Maps name hashes to indices in Ais::sFactories.
+util::PerfectHashTable<0x800> sFactoryIndex;
+}  // namespace
+
 inline res::AIProgram* ActionBase::getAIProg() const {
     return mActor->getParam()->getRes().mAIProgram;
 }
@@ -92,7 +100,13 @@ bool Ai::gatherParamsFromChildren(sead::Heap* heap) {
 }
 
 void Ai::calc() {
-    calc_();
+    if (Trace::isEnabled()) {
+        const sead::TickTime start;
+        calc_();
+        Trace::recordCalc(this, sead::TickTime().diff(start).toTicks());
+    } else {
+        calc_();
+    }
 
     auto* child = getCurrentChild();
     if (child)
@@ -382,6 +396,11 @@ void Ais::onPreDelete() const {
 
 AiFactory* Ais::getFactory(const sead::SafeString& name) {
     const u32 name_hash = sead::HashCRC32::calcStringHash(name);
+    if (sFactoryIndex.isValid()) {
+        AiFactory* factory = sFactories.get(sFactoryIndex.find(name_hash));
+        return factory->hash == name_hash ? factory : nullptr;
+    }
+
     const s32 idx = sFactories.binarySearch(
         name_hash, +[](const AiFactory& factory, const u32& hash) {
             if (factory.hash < hash)
@@ -397,6 +416,7 @@ AiFactory* Ais::getFactory(const sead::SafeString& name) {
 
 void Ais::setFactories(int count, AiFactory* factories) {
     sFactories.setBuffer(count, factories);
+    sFactoryIndex.build(count, [factories](s32 i) { return factories[i].hash; });
 }
 
 sead::Buffer<AiFactory> Ais::sFactories;
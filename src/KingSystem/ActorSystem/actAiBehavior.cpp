@@ -1,12 +1,98 @@
 #include "KingSystem/ActorSystem/actAiBehavior.h"
+#include <algorithm>
+#include <basis/seadRawPrint.h>
+#include <heap/seadExpHeap.h>
+#include <prim/seadScopedLock.h>
+#include <thread/seadAtomic.h>
+#include <thread/seadCriticalSection.h>
 #include "KingSystem/ActorSystem/actActor.h"
 #include "KingSystem/ActorSystem/actActorParam.h"
 #include "KingSystem/ActorSystem/actAiRoot.h"
 #include "KingSystem/ActorSystem/behaviorDummyBehavior.h"
 #include "KingSystem/Resource/Actor/resResourceAIProgram.h"
+#include "KingSystem/Utils/Container/PerfectHashTable.h"
 
 namespace ksys::act::ai {
 
+namespace {
+/// Maps name hashes to indices in Behaviors::sFactories.
+util::PerfectHashTable<0x100> sFactoryIndex;
+
+struct UsageEntry {
+    u32 name_hash;
+    sead::FixedSafeString<64> name;
+    Behaviors::UsageStats stats;
+};
+
+struct ClassUsageEntry {
+    u32 name_hash;
+    u32 num_instances;
+    u32 num_activated;
+    bool eager;
+};
+
+constexpr u32 UsageMask = Behaviors::MaxUsageStats - 1;
+static_assert((Behaviors::MaxUsageStats & UsageMask) == 0);
+
+constexpr u32 EagerSetSize = 2 * Behaviors::MaxEagerClasses;
+constexpr u32 EagerSetMask = EagerSetSize - 1;
+static_assert((EagerSetSize & EagerSetMask) == 0);
+
+struct LazyState {
+    /// Open-addressed set of the name hashes of the classes that are never created lazily.
+    /// Entries are only ever added (with usage_cs held), so it can be read without a lock.
+    sead::Atomic<u32> eager_classes[EagerSetSize]{};
+    s32 num_eager_classes = 0;
+    f32 eager_activation_rate = 0.0;
+    u32 min_samples = 0;
+    u32 min_free_pool_size = 0;
+    sead::Heap* fallback_heap = nullptr;
+    sead::CriticalSection usage_cs;
+    UsageEntry usage[Behaviors::MaxUsageStats]{};
+    ClassUsageEntry class_usage[Behaviors::MaxUsageStats]{};
+};
+
+LazyState sLazy;
+
+// The hash of the empty string is 0, which marks empty slots.
+void addEagerClass(u32 name_hash) {
+    if (sLazy.num_eager_classes >= Behaviors::MaxEagerClasses)
+        return;
+
+    for (u32 idx = name_hash & EagerSetMask;; idx = (idx + 1) & EagerSetMask) {
+        const u32 entry = sLazy.eager_classes[idx];
+        if (entry == name_hash)
+            return;
+        if (entry == 0) {
+            sLazy.eager_classes[idx].store(name_hash);
+            ++sLazy.num_eager_classes;
+            return;
+        }
+    }
+}
+
+/// Must be called with usage_cs held.
+void recordClassUsage(u32 name_hash, bool activated) {
+    for (u32 i = 0, idx = name_hash & UsageMask; i < Behaviors::MaxUsageStats;
+         ++i, idx = (idx + 1) & UsageMask) {
+        auto& entry = sLazy.class_usage[idx];
+        if (entry.num_instances == 0)
+            entry.name_hash = name_hash;
+        else if (entry.name_hash != name_hash)
+            continue;
+
+        ++entry.num_instances;
+        entry.num_activated += activated;
+        if (!entry.eager && entry.num_instances >= sLazy.min_samples &&
+            f32(entry.num_activated) >= sLazy.eager_activation_rate * f32(entry.num_instances)) {
+            entry.eager = true;
+            addEagerClass(name_hash);
+        }
+        return;
+    }
+}
+}  // namespace
+
 Behavior::Behavior(const InitArg& arg)
     : mActor(arg.actor), mDefIdx(static_cast<u16>(arg.def_idx)) {}
 
@@ -40,6 +126,29 @@ bool Behaviors::init(Actor* actor, sead::Heap* heap) {
         return false;
     for (s32 i = 0, n = mClasses.size(); i != n; ++i)
         mClasses(i) = nullptr;
+
+    if (shouldCreateLazily()) {
+        // Any behavior may end up being created, so make room for all of them.
+        if (!mOnPreDeleteCbs.tryAllocBuffer(num_behaviors, heap))
+            return false;
+        if (!mUpdateForPreDeleteCbs.tryAllocBuffer(num_behaviors, heap))
+            return false;
+        for (s32 i = 0; i < num_behaviors; ++i) {
+            mOnPreDeleteCbs(i) = nullptr;
+            mUpdateForPreDeleteCbs(i) = nullptr;
+        }
+
+        for (s32 i = 0; i < num_behaviors; ++i) {
+            const char* name = aiprog->getBehaviors()[i].mClassName;
+            if (!isEagerClass(name))
+                continue;
+
+            if (!createBehavior(actor, i, getFactory(name), heap))
+                return false;
+        }
+        return true;
+    }
+
     auto it_class = mClasses.begin();
     const auto it_class_end = mClasses.end();
 
@@ -99,6 +208,102 @@ bool Behaviors::init(Actor* actor, sead::Heap* heap) {
     return true;
 }
 
+Behavior* Behaviors::activate(Actor* actor, s32 idx) {
+    if (mClasses[idx] || !isLazyInstantiationEnabled())
+        return mClasses[idx];
+
+    const auto* aiprog = actor->getParam()->getRes().mAIProgram;
+    auto* factory = getFactory(aiprog->getBehaviors()[idx].mClassName);
+
+    if (createBehavior(actor, idx, factory, sPool))
+        return mClasses[idx];
+
+    // The pool is exhausted. The actor's own heap has been adjusted to fit the AI tree by now,
+    // so fall back to the parent heap of the pool.
+    if (createBehavior(actor, idx, factory, sLazy.fallback_heap))
+        return mClasses[idx];
+
+    // With eager instantiation, running out of memory fails actor creation. This actor already
+    // exists, so delete it rather than letting it run without one of its behaviors.
+    SEAD_WARN("Behaviors::activate: failed to create %s, deleting the actor",
+              aiprog->getBehaviors()[idx].mClassName);
+    actor->deleteLater(BaseProc::DeleteReason::_1);
+    return nullptr;
+}
+
+bool Behaviors::createBehavior(Actor* actor, s32 idx, BehaviorFactory* factory,
+                               sead::Heap* heap) {
+    Behavior::InitArg arg;
+    arg.actor = actor;
+    arg.def_idx = idx;
+
+    Behavior* behavior;
+    if (factory)
+        behavior = factory->create_fn(arg, heap);
+    else
+        behavior = new (heap, std::nothrow_t()) DummyBehavior(arg);
+
+    if (!behavior)
+        return false;
+
+    if (!behavior->init(heap)) {
+        delete behavior;
+        return false;
+    }
+
+    // The callback lists have one entry per behavior, so there is always a free slot.
+    if (behavior->hasUpdateForPreDeleteCb()) {
+        auto* it = std::find(mUpdateForPreDeleteCbs.begin(), mUpdateForPreDeleteCbs.end(),
+                             nullptr);
+        *it = behavior;
+    }
+
+    if (behavior->hasPreDeleteCb()) {
+        auto* it = std::find(mOnPreDeleteCbs.begin(), mOnPreDeleteCbs.end(), nullptr);
+        *it = behavior;
+    }
+
+    mClasses[idx] = behavior;
+    return true;
+}
+
+void Behaviors::recordUsage(const Actor* actor) const {
+    if (!isLazyInstantiationEnabled() || mClasses.size() == 0)
+        return;
+
+    const auto* aiprog = actor->getParam()->getRes().mAIProgram;
+
+    u32 num_untouched = 0;
+    for (auto* behavior : mClasses)
+        num_untouched += behavior == nullptr;
+
+    const auto& name = actor->getName();
+    const u32 name_hash = sead::HashCRC32::calcStringHash(name);
+
+    const auto lock = sead::makeScopedLock(sLazy.usage_cs);
+
+    for (s32 i = 0; i < mClasses.size(); ++i) {
+        const char* class_name = aiprog->getBehaviors()[i].mClassName;
+        recordClassUsage(sead::HashCRC32::calcStringHash(class_name), mClasses[i] != nullptr);
+    }
+    for (u32 i = 0, idx = name_hash & UsageMask; i < MaxUsageStats;
+         ++i, idx = (idx + 1) & UsageMask) {
+        auto& entry = sLazy.usage[idx];
+        if (entry.stats.num_actors == 0) {
+            entry.name_hash = name_hash;
+            entry.name = name;
+            entry.stats.actor_name = entry.name.cstr();
+        } else if (entry.name_hash != name_hash) {
+            continue;
+        }
+
+        ++entry.stats.num_actors;
+        entry.stats.num_behaviors += mClasses.size();
+        entry.stats.num_untouched += num_untouched;
+        return;
+    }
+}
+
 bool Behaviors::updateForPreDelete() const {
     bool ok = true;
     for (auto* cb : mUpdateForPreDeleteCbs) {
@@ -117,6 +322,11 @@ void Behaviors::onPreDelete() const {
 
 BehaviorFactory* Behaviors::getFactory(const sead::SafeString& name) {
     const u32 name_hash = sead::HashCRC32::calcStringHash(name);
+    if (sFactoryIndex.isValid()) {
+        BehaviorFactory* factory = sFactories.get(sFactoryIndex.find(name_hash));
+        return factory->hash == name_hash ? factory : nullptr;
+    }
+
     const s32 idx = sFactories.binarySearch(
         name_hash, +[](const BehaviorFactory& factory, const u32& hash) {
             if (factory.hash < hash)
@@ -132,6 +342,69 @@ BehaviorFactory* Behaviors::getFactory(const sead::SafeString& name) {
 
 void Behaviors::setFactories(int count, BehaviorFactory* factories) {
     sFactories.setBuffer(count, factories);
+    sFactoryIndex.build(count, [factories](s32 i) { return factories[i].hash; });
+}
+
+bool Behaviors::initLazyInstantiation(const LazyInitArg& arg, sead::Heap* heap) {
+    if (sPool || arg.num_eager_classes > MaxEagerClasses)
+        return false;
+
+    // Behaviors are created from whichever thread runs the actor's AI, so the pool needs a lock.
+    auto* pool = sead::ExpHeap::create(arg.pool_size, "AiBehaviorPool", heap, sizeof(void*),
+                                       sead::Heap::cHeapDirection_Forward, true);
+    if (!pool)
+        return false;
+
+    for (s32 i = 0; i < arg.num_eager_classes; ++i)
+        addEagerClass(sead::HashCRC32::calcStringHash(arg.eager_classes[i]));
+    sLazy.eager_activation_rate = arg.eager_activation_rate;
+    sLazy.min_samples = arg.min_samples;
+    sLazy.min_free_pool_size = arg.min_free_pool_size;
+    sLazy.fallback_heap = heap;
+
+    sPool = pool;
+    return true;
+}
+
+bool Behaviors::shouldCreateLazily() {
+    return isLazyInstantiationEnabled() && sPool->getFreeSize() >= sLazy.min_free_pool_size;
+}
+
+bool Behaviors::isEagerClass(const char* name) {
+    const u32 hash = sead::HashCRC32::calcStringHash(name);
+    for (u32 idx = hash & EagerSetMask;; idx = (idx + 1) & EagerSetMask) {
+        const u32 entry = sLazy.eager_classes[idx];
+        if (entry == hash)
+            return true;
+        // The set is never more than half full, so this always reaches an empty slot.
+        if (entry == 0)
+            return false;
+    }
+}
+
+s32 Behaviors::getUsageStats(UsageStats* stats, s32 max_stats) {
+    const auto compare = [](const UsageStats& lhs, const UsageStats& rhs) {
+        return lhs.num_untouched > rhs.num_untouched;
+    };
+
+    const auto lock = sead::makeScopedLock(sLazy.usage_cs);
+    s32 num_stats = 0;
+    for (const auto& entry : sLazy.usage) {
+        if (entry.stats.num_actors == 0)
+            continue;
+
+        // Keep the array sorted and only retain the max_stats actors with the most waste.
+        if (num_stats == max_stats) {
+            if (max_stats == 0 || !compare(entry.stats, stats[num_stats - 1]))
+                continue;
+            --num_stats;
+        }
+        UsageStats* it = std::upper_bound(stats, stats + num_stats, entry.stats, compare);
+        std::move_backward(it, stats + num_stats, stats + num_stats + 1);
+        *it = entry.stats;
+        ++num_stats;
+    }
+    return num_stats;
 }
 
 }  // namespace ksys::act::ai
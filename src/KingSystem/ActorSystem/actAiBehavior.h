@@ -57,6 +57,34 @@ struct BehaviorFactory {
 
 class Behaviors {
 public:
+    static constexpr s32 MaxEagerClasses = 0x40;
+    static constexpr s32 MaxUsageStats = 0x400;
+
+    struct LazyInitArg {
+        /// Size of the heap that lazily created behaviors are allocated from.
+        u32 pool_size = 0x100000;
+        /// When less than this is free in the pool, new actors create all their behaviors
+        /// together with the AI tree, as if lazy instantiation were disabled.
+        u32 min_free_pool_size = 0x10000;
+        /// Classes that are always created together with the AI tree, for behaviors that
+        /// must be warm by the time they are first activated.
+        const char* const* eager_classes = nullptr;
+        s32 num_eager_classes = 0;
+        /// A class is added to the eager classes once at least `min_samples` of its instances
+        /// have been recorded (see recordUsage) and at least this fraction of them was activated.
+        f32 eager_activation_rate = 0.5;
+        u32 min_samples = 16;
+    };
+
+    struct UsageStats {
+        const char* actor_name;
+        u32 num_actors;
+        /// Total number of behavior definitions over all actors of this type.
+        u32 num_behaviors;
+        /// Number of behaviors that were still not created when the actor was deleted.
+        u32 num_untouched;
+    };
+
     Behaviors();
     ~Behaviors();
 
@@ -68,11 +96,40 @@ public:
 
     const sead::Buffer<Behavior*>& getClasses() const { return mClasses; }
 
+    /// @return the behavior, or nullptr if it has not been created yet.
+    Behavior* getBehavior(s32 idx) const { return mClasses[idx]; }
+    /// @return the behavior, creating it first if necessary. Behaviors that do not fit in the
+    ///         pool are allocated from the heap that was passed to initLazyInstantiation.
+    ///         If that fails too, the actor is deleted and nullptr is returned.
+    Behavior* activate(Actor* actor, s32 idx);
+
+    /// Counts the behaviors of an actor that were never activated, and updates the eager classes
+    /// accordingly. Only does anything if lazy instantiation is enabled. Must be called before
+    /// the actor is destroyed.
+    void recordUsage(const Actor* actor) const;
+
     static BehaviorFactory* getFactory(const sead::SafeString& name);
     static void setFactories(int count, BehaviorFactory* factories);
 
+    /// Enables lazy instantiation: instead of creating every behavior when the AI tree is
+    /// created, behaviors are created from a dedicated pool the first time they are activated.
+    /// This is disabled by default. Must be called before any actor is created.
+    /// @param heap  Parent of the pool. Also used for behaviors that do not fit in the pool,
+    ///              so it must be thread-safe.
+    static bool initLazyInstantiation(const LazyInitArg& arg, sead::Heap* heap);
+    static bool isLazyInstantiationEnabled() { return sPool != nullptr; }
+
+    /// Fills `stats` with the actor types that have the most untouched behaviors.
+    /// @return the number of entries that were written.
+    static s32 getUsageStats(UsageStats* stats, s32 max_stats);
+
 private:
+    bool createBehavior(Actor* actor, s32 idx, BehaviorFactory* factory, sead::Heap* heap);
+    static bool shouldCreateLazily();
+    static bool isEagerClass(const char* name);
+
     static inline sead::Buffer<BehaviorFactory> sFactories;
+    static inline sead::Heap* sPool = nullptr;
     sead::Buffer<Behavior*> mClasses;
     // Non-owning buffer.
     sead::Buffer<Behavior*> mOnPreDeleteCbs;
@@ -1,12 +1,14 @@
 #include "KingSystem/ActorSystem/actAiClassDef.h"
 #include <algorithm>
 #include <codec/seadHashCRC32.h>
+#include <math/seadMathCalcCommon.h>
 #include <prim/seadContainerIterator.h>
 #include <resource/seadResource.h>
 #include "KingSystem/ActorSystem/actAiParam.h"
 #include "KingSystem/Resource/resLoadRequest.h"
 #include "KingSystem/Utils/Byaml/ByamlData.h"
 #include "KingSystem/Utils/Byaml/ByamlHashIter.h"
+#include "KingSystem/Utils/Container/PerfectHashTable.h"
 
 namespace ksys {
 
@@ -24,7 +26,88 @@ const char* str_Querys = "Querys";
 
 SEAD_SINGLETON_DISPOSER_IMPL(AIClassDef)
 
+namespace {
+
+struct DecodedParam {
+    const char* name;
+    AIDefParamType type;
+    AIDef::Value value;
+};
+
+/// Everything getDef can return for a class, decoded once from the AIDef BYML.
+struct DecodedDef {
+    /// Index of the first parameter in DecodedDefs::params, for each AIDefInstParamKind.
+    u32 params_idx[NumAIDefInstParamKinds];
+    u16 num_params[NumAIDefInstParamKinds];
+    u32 children_idx;
+    u16 num_children;
+    CalcTiming calc_timing;
+    bool no_stop;
+    bool trigger_action;
+    bool dynamic_param_child;
+};
+
+struct DecodedDefs {
+    /// Maps name hashes to indices in AIClassDef::Data::defs (and in defs below).
+    util::PerfectHashTable<0x800> index[NumAIDefTypes];
+    sead::Buffer<DecodedDef> defs[NumAIDefTypes];
+    sead::Buffer<DecodedParam> params;
+    sead::Buffer<const char*> children;
+    /// One bit per query definition.
+    sead::Buffer<u32> system_query_bits;
+    bool valid = false;
+};
+
+DecodedDefs sDecodedDefs;
+
+template <typename Callback>
+void forEachChild(const al::ByamlIter& iter, s32 idx_Childs, const Callback& callback) {
+    al::ByamlHashIter hash_iter{iter.getRootNode()};
+    al::ByamlData byaml_data;
+    if (!hash_iter.getDataByKey(&byaml_data, idx_Childs))
+        return;
+
+    al::ByamlIter it{iter.getData(), iter.getData() + byaml_data.getValue()};
+    if (!it.isValid())
+        return;
+
+    const s32 num_children = it.getSize();
+    for (s32 i = 0; i < num_children; ++i) {
+        const char* child = nullptr;
+        if (!it.tryGetStringByIndex(&child, i))
+            child = nullptr;
+        callback(child);
+    }
+}
+
+void copyDecodedDef(AIDef* def, const DecodedDef& decoded, AIDefInstParamKind param_kind) {
+    if (param_kind == AIDefInstParamKind::Static) {
+        def->calc_timing = decoded.calc_timing;
+        def->no_stop = decoded.no_stop;
+        def->trigger_action = decoded.trigger_action;
+        def->dynamic_param_child = decoded.dynamic_param_child;
+    }
+
+    const s32 kind = s32(param_kind);
+    const DecodedParam* params = &sDecodedDefs.params[decoded.params_idx[kind]];
+    def->num_params = decoded.num_params[kind];
+    for (s32 i = 0; i < def->num_params; ++i) {
+        def->param_names[i] = params[i].name;
+        def->param_types[i] = params[i].type;
+        def->param_values[i] = params[i].value;
+    }
+}
+
+const DecodedDef* getDecodedDef(s32 idx, AIDefType type) {
+    if (!sDecodedDefs.valid)
+        return nullptr;
+    return &sDecodedDefs.defs[s32(type)][idx];
+}
+
+}  // namespace
+
 AIClassDef::~AIClassDef() {
+    freeIndex();
     freeData();
 }
 
@@ -37,9 +120,120 @@ void AIClassDef::init(const sead::SafeString& aidef_file_name, sead::Heap* heap)
 
     auto* res = sead::DynamicCast<sead::DirectResource>(mResHandle.load(path, &req));
 
+    freeIndex();
     freeData();
     mData = new (heap) Data(res->getRawData());
     mData->load(heap);
+    buildIndex(heap);
+}
+
+void AIClassDef::buildIndex(sead::Heap* heap) {
+    auto& decoded = sDecodedDefs;
+
+    // Index the definitions that Data::load has sorted by name hash.
+    for (s32 type = 0; type < NumAIDefTypes; ++type) {
+        const auto& raw_defs = getRawDefs(AIDefType(type));
+        decoded.index[type].build(raw_defs.size(),
+                                  [&raw_defs](s32 i) { return raw_defs[i].name_hash; });
+    }
+
+    // First pass: count parameters and children so that they can be stored contiguously.
+    auto* tmp = new (heap, std::nothrow_t()) AIDef;
+    if (!tmp)
+        return;
+
+    s32 total_params = 0;
+    s32 total_children = 0;
+    for (s32 type = 0; type < NumAIDefTypes; ++type) {
+        for (const auto& raw_def : getRawDefs(AIDefType(type))) {
+            for (s32 kind = 0; kind < NumAIDefInstParamKinds; ++kind) {
+                doGetDef(tmp, raw_def.iter, AIDefInstParamKind(kind), AIDefType(type),
+                         mData->inst_params_key_idx[kind]);
+                total_params += tmp->num_params;
+            }
+            if (AIDefType(type) == AIDefType::AI) {
+                forEachChild(raw_def.iter, mData->idx_Childs,
+                             [&](const char*) { ++total_children; });
+            }
+        }
+    }
+
+    const s32 num_queries = getRawDefs(AIDefType::Query).size();
+    bool ok = decoded.params.tryAllocBuffer(sead::Mathi::max(total_params, 1), heap) &&
+              decoded.children.tryAllocBuffer(sead::Mathi::max(total_children, 1), heap) &&
+              decoded.system_query_bits.tryAllocBuffer((num_queries + 31) / 32 + 1, heap);
+    for (s32 type = 0; ok && type < NumAIDefTypes; ++type) {
+        const s32 num_defs = getRawDefs(AIDefType(type)).size();
+        ok = num_defs == 0 || decoded.defs[type].tryAllocBuffer(num_defs, heap);
+    }
+    if (!ok) {
+        delete tmp;
+        freeIndex();
+        return;
+    }
+
+    // Second pass: decode everything.
+    u32 params_idx = 0;
+    u32 children_idx = 0;
+    for (s32 type = 0; type < NumAIDefTypes; ++type) {
+        const auto& raw_defs = getRawDefs(AIDefType(type));
+        for (s32 i = 0; i < raw_defs.size(); ++i) {
+            auto& def = decoded.defs[type][i];
+            for (s32 kind = 0; kind < NumAIDefInstParamKinds; ++kind) {
+                doGetDef(tmp, raw_defs[i].iter, AIDefInstParamKind(kind), AIDefType(type),
+                         mData->inst_params_key_idx[kind]);
+
+                if (AIDefInstParamKind(kind) == AIDefInstParamKind::Static) {
+                    def.calc_timing = tmp->calc_timing;
+                    def.no_stop = tmp->no_stop;
+                    def.trigger_action = tmp->trigger_action;
+                    def.dynamic_param_child = tmp->dynamic_param_child;
+                }
+
+                def.params_idx[kind] = params_idx;
+                def.num_params[kind] = u16(tmp->num_params);
+                for (s32 j = 0; j < tmp->num_params; ++j) {
+                    auto& param = decoded.params[params_idx++];
+                    param.name = tmp->param_names[j];
+                    param.type = tmp->param_types[j];
+                    param.value = tmp->param_values[j];
+                }
+            }
+
+            def.children_idx = children_idx;
+            def.num_children = 0;
+            if (AIDefType(type) == AIDefType::AI) {
+                forEachChild(raw_defs[i].iter, mData->idx_Childs, [&](const char* child) {
+                    decoded.children[children_idx++] = child;
+                    ++def.num_children;
+                });
+            }
+        }
+    }
+
+    decoded.system_query_bits.fill(0);
+    const auto& queries = getRawDefs(AIDefType::Query);
+    for (s32 i = 0; i < queries.size(); ++i) {
+        bool is_system_query = false;
+        queries[i].iter.tryGetBoolByKey(&is_system_query, "SystemQuery");
+        if (is_system_query)
+            decoded.system_query_bits[i / 32] |= 1u << (i % 32);
+    }
+
+    delete tmp;
+    decoded.valid = true;
+}
+
+void AIClassDef::freeIndex() {
+    auto& decoded = sDecodedDefs;
+    decoded.valid = false;
+    for (s32 type = 0; type < NumAIDefTypes; ++type) {
+        decoded.index[type].clear();
+        decoded.defs[type].freeBuffer();
+    }
+    decoded.params.freeBuffer();
+    decoded.children.freeBuffer();
+    decoded.system_query_bits.freeBuffer();
 }
 
 // not trying to match the heap sort. The rest should be equivalent
@@ -91,6 +285,12 @@ s32 AIClassDef::getRawDefIdx(const sead::SafeString& def_name, AIDefType type) c
     if (!mData)
         return -1;
 
+    const auto& index = sDecodedDefs.index[s32(type)];
+    if (index.isValid()) {
+        const s32 idx = index.find(hash);
+        return getRawDefs(type)[idx].name_hash == hash ? idx : -1;
+    }
+
     return getRawDefs(type).binarySearch(
         hash, +[](const Data::Def& def, const u32& hash) {
             if (def.name_hash < hash)
@@ -112,6 +312,16 @@ void AIClassDef::getDef(const sead::SafeString& class_name, AIDefSet* set,
     if (idx < 0)
         return;
 
+    if (const DecodedDef* decoded = getDecodedDef(idx, class_type)) {
+        set->num_children = decoded->num_children;
+        for (s32 i = 0; i < decoded->num_children; ++i)
+            set->children[i] = sDecodedDefs.children[decoded->children_idx + i];
+        copyDecodedDef(&set->dynamic_params, *decoded, AIDefInstParamKind::Dynamic);
+        copyDecodedDef(&set->map_unit_params, *decoded, AIDefInstParamKind::MapUnit);
+        copyDecodedDef(&set->ai_tree_params, *decoded, AIDefInstParamKind::AITree);
+        return;
+    }
+
     const auto* data = mData;
     const auto& iter = getRawDefs(class_type)[idx].iter;
 
@@ -277,6 +487,11 @@ void AIClassDef::getDef(AIDef* def, const sead::SafeString& class_name,
     if (idx < 0)
         return;
 
+    if (const DecodedDef* decoded = getDecodedDef(idx, class_type)) {
+        copyDecodedDef(def, *decoded, param_kind);
+        return;
+    }
+
     doGetDef(def, getRawDefs(class_type)[idx].iter, param_kind, class_type,
              mData->inst_params_key_idx[s32(param_kind)]);
 }
@@ -288,6 +503,9 @@ bool AIClassDef::isSystemQuery(const sead::SafeString& query) const {
     if (idx < 0)
         return false;
 
+    if (sDecodedDefs.valid)
+        return (sDecodedDefs.system_query_bits[idx / 32] >> (idx % 32)) & 1;
+
     getRawDefs(AIDefType::Query)[idx].iter.tryGetBoolByKey(&ret, "SystemQuery");
     return ret;
 }
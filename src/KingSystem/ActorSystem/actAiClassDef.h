@@ -130,6 +130,11 @@ private:
         util::safeDelete(mData);
     }
 
+    /// Decodes every definition for every parameter kind so that getDef and isSystemQuery
+    /// do not need to walk the BYML. Called by init.
+    void buildIndex(sead::Heap* heap);
+    void freeIndex();
+
     s32 getRawDefIdx(const sead::SafeString& def_name, AIDefType type) const;
     const sead::Buffer<Data::Def>& getRawDefs(AIDefType type) const {
         return mData->defs[s32(type)];
@@ -1,5 +1,8 @@
 #include "KingSystem/ActorSystem/actAiParam.h"
 #include <agl/Utils/aglParameter.h>
+#include <algorithm>
+#include <cstring>
+#include <new>
 #include "KingSystem/ActorSystem/actActor.h"
 #include "KingSystem/ActorSystem/actAiClassDef.h"
 #include "KingSystem/ActorSystem/actAiInlineParam.h"
@@ -10,71 +13,148 @@ class BaseProcHandle;
 
 namespace ksys::act::ai {
 
+struct ParamPack::TableEntry {
+    u32 hash;
+    Param* param;
+};
+
+struct ParamPack::Storage {
+    /// Block that was allocated by the previous load, if any.
+    Storage* prev;
+    /// Head of the list of all parameters in the pack, including those in older blocks.
+    Param* head;
+    /// Parameters whose node and value live in this block.
+    Param* params;
+    s32 num_params;
+    s32 num_total_params;
+    /// Open-addressed (linear probing) table covering every parameter in the pack.
+    /// It is allocated separately and owned by the newest block (nullptr in older blocks).
+    TableEntry* table;
+    u32 table_mask;
+};
+
+namespace {
+
+using StringParam = sead::FixedSafeString<80>;
+
+struct ValueLayout {
+    u32 size;
+    u32 alignment;
+};
+
+template <typename T>
+constexpr ValueLayout makeLayout() {
+    return {sizeof(T), alignof(T)};
+}
+
+/// @returns the layout of the value for the specified parameter type
+/// or a zero size if no value should be created.
+ValueLayout getValueLayout(AIDefParamType type, AIDefInstParamKind kind) {
+    const bool is_dynamic = kind == AIDefInstParamKind::Dynamic;
+    switch (type) {
+    case AIDefParamType::String:
+        return makeLayout<StringParam>();
+    case AIDefParamType::Int:
+        return makeLayout<int>();
+    case AIDefParamType::Float:
+        return makeLayout<float>();
+    case AIDefParamType::Vec3:
+        return makeLayout<sead::Vector3f>();
+    case AIDefParamType::Bool:
+        return makeLayout<bool>();
+    case AIDefParamType::AITreeVariablePointer:
+        return makeLayout<void*>();
+    case AIDefParamType::UInt:
+        return makeLayout<u32>();
+    case AIDefParamType::BaseProcLink:
+        return is_dynamic ? makeLayout<BaseProcLink>() : ValueLayout{0, 1};
+    case AIDefParamType::MesTransceiverId:
+        return is_dynamic ? makeLayout<MesTransceiverId>() : ValueLayout{0, 1};
+    case AIDefParamType::BaseProcHandle:
+        return is_dynamic ? makeLayout<BaseProcHandle*>() : ValueLayout{0, 1};
+    case AIDefParamType::Rail:
+        return is_dynamic ? makeLayout<Rail*>() : ValueLayout{0, 1};
+    case AIDefParamType::Tree:
+    case AIDefParamType::Other:
+        break;
+    }
+    return {0, 1};
+}
+
+size_t alignUp(size_t offset, size_t alignment) {
+    return (offset + alignment - 1) & ~(alignment - 1);
+}
+
+void destroyValue(Param& param) {
+    if (!param.data)
+        return;
+
+    switch (param.type) {
+    case AIDefParamType::String:
+        static_cast<StringParam*>(param.data)->~StringParam();
+        break;
+    case AIDefParamType::BaseProcLink:
+        static_cast<BaseProcLink*>(param.data)->~BaseProcLink();
+        break;
+    case AIDefParamType::MesTransceiverId:
+        static_cast<MesTransceiverId*>(param.data)->~MesTransceiverId();
+        break;
+    default:
+        // Everything else is trivially destructible.
+        break;
+    }
+}
+
+}  // namespace
+
 ParamPack::ParamPack() = default;
 
 ParamPack::~ParamPack() {
-    auto* param = mParams;
-    while (param) {
-        if (param->data) {
-            switch (param->type) {
-            case AIDefParamType::String:
-                delete static_cast<sead::SafeString*>(param->data);
-                break;
-            case AIDefParamType::Int:
-                delete static_cast<int*>(param->data);
-                break;
-            case AIDefParamType::Float:
-                delete static_cast<float*>(param->data);
-                break;
-            case AIDefParamType::Vec3:
-                delete static_cast<sead::Vector3f*>(param->data);
-                break;
-            case AIDefParamType::Bool:
-                delete static_cast<bool*>(param->data);
-                break;
-            case AIDefParamType::AITreeVariablePointer:
-                delete static_cast<void**>(param->data);
-                break;
-            case AIDefParamType::UInt:
-                delete static_cast<u32*>(param->data);
-                break;
-            case AIDefParamType::MesTransceiverId:
-                delete static_cast<MesTransceiverId*>(param->data);
-                break;
-            case AIDefParamType::BaseProcHandle:
-                delete static_cast<BaseProcHandle**>(param->data);
-                break;
-            case AIDefParamType::Rail:
-                delete static_cast<Rail**>(param->data);
-                break;
-            case AIDefParamType::BaseProcLink:
-                delete static_cast<BaseProcLink*>(param->data);
-                break;
-            default:
-                break;
-            }
-        }
-        param = mParams->next;
-        if (mParams)
-            delete mParams;
-        mParams = param;
+    if (mStorage)
+        delete[] mStorage->table;
+
+    while (mStorage) {
+        auto* storage = mStorage;
+        for (s32 i = 0; i < storage->num_params; ++i)
+            destroyValue(storage->params[i]);
+        mStorage = storage->prev;
+        delete[] reinterpret_cast<u8*>(storage);
     }
 }
 
-template <typename T>
-T* ParamPack::getVariable(const sead::SafeString& key, AIDefParamType type, bool a4) const {
-    const u32 hash = agl::utl::ParameterBase::calcHash(key);
-    auto* param = mParams;
-    if (!param)
+u32 ParamPack::calcHash(const sead::SafeString& key) {
+    return agl::utl::ParameterBase::calcHash(key);
+}
+
+Param* ParamPack::getParams() const {
+    return mStorage ? mStorage->head : nullptr;
+}
+
+Param* ParamPack::findParam(u32 hash) const {
+    if (!mStorage)
         return nullptr;
-    while (param->hash != hash || param->type != type) {
-        param = param->next;
-        if (!param)
+
+    const TableEntry* table = mStorage->table;
+    const u32 mask = mStorage->table_mask;
+    // The table is never more than half full, so this always reaches an empty entry.
+    for (u32 i = hash & mask;; i = (i + 1) & mask) {
+        if (!table[i].param)
             return nullptr;
+        if (table[i].hash == hash)
+            return table[i].param;
     }
-    if (a4)
-        param->used = true;
-    return static_cast<T*>(param->data);
+}
+
+Param* ParamPack::resolveSlot(u32 hash, AIDefParamType type) const {
+    Param* param = findParam(hash);
+    if (!param || param->type != type)
+        return nullptr;
+    return param;
+}
+
+template <typename T>
+T* ParamPack::getVariable(const sead::SafeString& key, AIDefParamType type, bool a4) const {
+    return getVariable<T>(calcHash(key), type, a4);
 }
 
 bool ParamPack::load(const Actor& actor, const ParamNameTypePairs& pairs, s32 count,
@@ -107,7 +187,7 @@ void* ParamPack::getAITreeVariablePointer(const sead::SafeString& key, AIDefPara
 }
 
 void ParamPack::copy(InlineParamPack* dest, bool x) const {
-    for (auto* param = mParams; param; param = param->next) {
+    for (auto* param = getParams(); param; param = param->next) {
         if (!param->data || !param->used)
             continue;
 
@@ -220,12 +300,51 @@ void InlineParamPack::addMesTransceiverId(const MesTransceiverId& value,
 }
 
 void ParamPack::getPairs(ParamNameTypePairs* pairs, bool update_use_count) const {
-    for (auto* param = mParams; param; param = param->next) {
+    for (auto* param = getParams(); param; param = param->next) {
         if (param->data)
             pairs->addPair(param->type, param->name, update_use_count);
     }
 }
 
+StaticParamSlotTable* StaticParamSlotTable::sBuckets[NumBuckets]{};
+
+StaticParamSlotTable::StaticParamSlotTable(AIDefType type, const char* class_name,
+                                           StaticParamSlot* slots, s32 num_slots)
+    : mType(type), mClassName(class_name), mClassNameHash(util::calcCrc32(class_name)),
+      mSlots(slots), mNumSlots(num_slots) {
+    // Tables are static objects, so this only runs during static initialisation (single-threaded).
+    auto& bucket = sBuckets[getBucketIdx(type, mClassNameHash)];
+    mNext = bucket;
+    bucket = this;
+}
+
+void StaticParamSlotTable::resolve(AIDefType type, const sead::SafeString& class_name,
+                                   const AIDef& def) {
+    const u32 hash = util::calcCrc32(class_name.cstr());
+    for (auto* table = sBuckets[getBucketIdx(type, hash)]; table; table = table->mNext) {
+        if (table->mType != type || table->mClassNameHash != hash)
+            continue;
+        if (class_name != table->mClassName)
+            continue;
+
+        if (table->mResolved)
+            return;
+
+        for (s32 i = 0; i < table->mNumSlots; ++i) {
+            auto& slot = table->mSlots[i];
+            for (s32 j = 0; j < def.num_params; ++j) {
+                if (def.param_names[j] && util::calcCrc32(def.param_names[j]) == slot.hash) {
+                    slot.index.store(j);
+                    break;
+                }
+            }
+        }
+
+        table->mResolved.store(true);
+        return;
+    }
+}
+
 void ParamNameTypePairs::addPair(AIDefParamType type, const sead::SafeString& name,
                                  bool update_use_count) {
     for (s32 i = 0; i < count; ++i) {
@@ -255,6 +374,14 @@ bool ParamPack::getString(sead::SafeString* value, const sead::SafeString& key)
     return true;
 }
 
+bool ParamPack::getStringByHash(sead::SafeString* value, u32 hash) const {
+    auto* str = getVariable<sead::SafeString>(hash, AIDefParamType::String, false);
+    if (!str)
+        return false;
+    *value = str->cstr();
+    return true;
+}
+
 bool ParamPack::setString(const sead::SafeString& value, const sead::SafeString& key) const {
     auto* str = getVariable<sead::BufferedSafeString>(key, AIDefParamType::String);
     if (!str)
@@ -292,49 +419,101 @@ bool ParamPack::load(const Actor& actor, const AIDef& def, sead::Heap* heap,
         used = true;
     }
 
-    const auto& iter = actor.getMapObjIter();
+    // First pass: find out which parameters are new and how much space their values need.
+    constexpr size_t NoValue = ~size_t(0);
+    s32 new_indices[AIDef::NumParametersMax];
+    u32 new_hashes[AIDef::NumParametersMax];
+    size_t new_offsets[AIDef::NumParametersMax];
+    s32 num_new = 0;
+    size_t values_size = 0;
+    bool ok = true;
+
     for (s32 i = 0; i < def.num_params; ++i) {
-        const auto hash = agl::utl::ParameterBase::calcHash(def.param_names[i]);
+        const u32 hash = calcHash(def.param_names[i]);
+        if (findParam(hash) ||
+            std::find(new_hashes, new_hashes + num_new, hash) != new_hashes + num_new) {
+            continue;
+        }
 
-        bool found = false;
-        for (auto* entry = mParams; entry; entry = entry->next) {
-            if (entry->hash == hash) {
-                found = true;
-                break;
-            }
+        new_indices[num_new] = i;
+        new_hashes[num_new] = hash;
+
+        const ValueLayout layout = getValueLayout(def.param_types[i], kind);
+        if (layout.size == 0) {
+            // Like the original implementation, keep the parameter (without a value) and stop.
+            new_offsets[num_new++] = NoValue;
+            ok = false;
+            break;
         }
-        if (found)
-            continue;
 
-        // Otherwise, allocate a new entry.
-        auto* entry = new (heap) Param;
-        if (!entry)
+        new_offsets[num_new] = alignUp(values_size, layout.alignment);
+        values_size = new_offsets[num_new] + layout.size;
+        ++num_new;
+    }
+
+    if (num_new == 0)
+        return ok;
+
+    const s32 num_total = (mStorage ? mStorage->num_total_params : 0) + num_new;
+
+    // The lookup table is only replaced when it would become more than half full.
+    TableEntry* const old_table = mStorage ? mStorage->table : nullptr;
+    TableEntry* table = old_table;
+    u32 table_size = mStorage ? mStorage->table_mask + 1 : 0;
+    if (table_size < u32(2 * num_total)) {
+        table_size = std::max(table_size, 8u);
+        while (table_size < u32(2 * num_total))
+            table_size *= 2;
+
+        table = new (heap, std::nothrow_t()) TableEntry[table_size];
+        if (!table)
             return false;
-        entry->data = nullptr;
-        entry->next = mParams;
-        mParams = entry;
-        switch (def.param_types[i]) {
+    }
+
+    const size_t params_offset = alignUp(sizeof(Storage), alignof(Param));
+    const size_t values_offset = alignUp(params_offset + sizeof(Param) * num_new, 0x10);
+
+    auto* block = new (heap, 0x10, std::nothrow_t()) u8[values_offset + values_size];
+    if (!block) {
+        if (table != old_table)
+            delete[] table;
+        return false;
+    }
+
+    auto* storage = reinterpret_cast<Storage*>(block);
+    storage->prev = mStorage;
+    storage->params = reinterpret_cast<Param*>(block + params_offset);
+    storage->num_params = num_new;
+    storage->num_total_params = num_total;
+    storage->table = table;
+    storage->table_mask = table_size - 1;
+    u8* values = block + values_offset;
+
+    const auto& iter = actor.getMapObjIter();
+    for (s32 j = 0; j < num_new; ++j) {
+        const s32 i = new_indices[j];
+        void* data = new_offsets[j] != NoValue ? values + new_offsets[j] : nullptr;
+
+        switch (data ? def.param_types[i] : AIDefParamType::Other) {
         case AIDefParamType::String: {
             const char* value = def.param_values[i].str ? def.param_values[i].str : "";
-
             if (load_map_unit_params)
                 iter.tryGetParamStringByKey(&value, def.param_names[i]);
-
-            entry->data = new (heap) sead::FixedSafeString<80>(value);
+            new (data) StringParam(value);
             break;
         }
         case AIDefParamType::Int: {
             int value = def.param_values[i].i;
             if (load_map_unit_params)
                 iter.tryGetParamIntByKey(&value, def.param_names[i]);
-            entry->data = new (heap) int(value);
+            new (data) int(value);
             break;
         }
         case AIDefParamType::Float: {
             float value = def.param_values[i].f;
             if (load_map_unit_params)
                 iter.tryGetParamFloatByKey(&value, def.param_names[i]);
-            entry->data = new (heap) float(value);
+            new (data) float(value);
             break;
         }
         case AIDefParamType::Vec3: {
@@ -342,58 +521,80 @@ bool ParamPack::load(const Actor& actor, const AIDef& def, sead::Heap* heap,
             sead::Vector3f value{src.x, src.y, src.z};
             if (load_map_unit_params)
                 iter.tryGetFloatArrayByKey(value.e.data(), def.param_names[i]);
-            entry->data = new (heap) sead::Vector3f(value);
+            new (data) sead::Vector3f(value);
             break;
         }
         case AIDefParamType::Bool: {
             bool value = def.param_values[i].b;
             if (load_map_unit_params)
                 iter.tryGetParamBoolByKey(&value, def.param_names[i]);
-            entry->data = new (heap) bool(value);
+            new (data) bool(value);
             break;
         }
         case AIDefParamType::AITreeVariablePointer:
-            entry->data = new (heap) void*();
+            new (data) void*();
             break;
         case AIDefParamType::UInt: {
             u32 value = def.param_values[i].u;
             if (load_map_unit_params)
                 iter.tryGetParamUIntByKey(&value, def.param_names[i]);
-            entry->data = new (heap) u32(value);
+            new (data) u32(value);
             break;
         }
         case AIDefParamType::BaseProcLink:
-            if (kind == AIDefInstParamKind::Dynamic)
-                entry->data = new (heap) BaseProcLink();
+            new (data) BaseProcLink();
             break;
         case AIDefParamType::MesTransceiverId:
-            if (kind == AIDefInstParamKind::Dynamic)
-                entry->data = new (heap) MesTransceiverId();
+            new (data) MesTransceiverId();
             break;
         case AIDefParamType::BaseProcHandle:
-            if (kind == AIDefInstParamKind::Dynamic)
-                entry->data = new (heap) BaseProcHandle*();
+            new (data) BaseProcHandle*();
             break;
         case AIDefParamType::Rail:
-            if (kind == AIDefInstParamKind::Dynamic)
-                entry->data = new (heap) Rail*();
+            new (data) Rail*();
             break;
         case AIDefParamType::Tree:
         case AIDefParamType::Other:
             break;
         }
 
-        if (!entry->data)
-            return false;
+        // New parameters are prepended to the list (so the list is in reverse definition order),
+        // which is the order that copy() and getPairs() have always iterated in.
+        auto& entry = storage->params[j];
+        entry.next = j > 0 ? &storage->params[j - 1] : getParams();
+        entry.hash = new_hashes[j];
+        entry.name = def.param_names[i];
+        entry.data = data;
+        entry.type = def.param_types[i];
+        entry.used = used;
+        entry._23 = def._24b;
+    }
+    storage->head = &storage->params[num_new - 1];
+
+    // A new table needs every parameter; an existing table only needs the new ones.
+    Param* const end = table != old_table ? nullptr : storage->params[0].next;
+    if (table != old_table)
+        std::memset(table, 0, sizeof(TableEntry) * table_size);
+
+    for (auto* param = storage->head; param != end; param = param->next) {
+        for (u32 idx = param->hash & storage->table_mask;; idx = (idx + 1) & storage->table_mask) {
+            auto& slot = table[idx];
+            if (!slot.param) {
+                slot.hash = param->hash;
+                slot.param = param;
+                break;
+            }
+        }
+    }
 
-        entry->hash = hash;
-        entry->name = def.param_names[i];
-        entry->used = used;
-        entry->_23 = def._24b;
-        entry->type = def.param_types[i];
+    if (mStorage) {
+        mStorage->table = nullptr;
+        if (table != old_table)
+            delete[] old_table;
     }
 
-    return true;
+    mStorage = storage;
+    return ok;
 }
 
 void InlineParamPack::addPointer(void* value, const sead::SafeString& key, AIDefParamType type,
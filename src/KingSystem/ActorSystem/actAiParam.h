@@ -4,7 +4,10 @@
 #include <container/seadSafeArray.h>
 #include <prim/seadSafeString.h>
 #include <prim/seadSizedEnum.h>
+#include <string_view>
+#include <thread/seadAtomic.h>
 
+#include "KingSystem/Utils/HashUtil.h"
 #include "KingSystem/Utils/Types.h"
 
 namespace ksys {
@@ -18,6 +21,7 @@ class BaseProcLink;
 struct AIDef;
 class Rail;
 enum class AIDefInstParamKind;
+enum class AIDefType;
 
 enum class AIDefParamType {
     String = 0,
@@ -54,6 +58,60 @@ struct ParamNameTypePairs {
 };
 KSYS_CHECK_SIZE_NX150(ParamNameTypePairs, 0x208);
 
+/// Key for a static (SInst) parameter, for use in generated loadParams_ functions.
+///
+/// The name hash is computed once when the key is created. Static parameters are stored in
+/// AIClassDef order, which is the same for every definition of a given class, so the index that
+/// a key resolves to is cached here and shared by all AI programs that use the class.
+struct StaticParamSlot {
+    explicit StaticParamSlot(std::string_view name_)
+        : name(name_.data()), hash(util::calcCrc32(name_)) {}
+
+    const char* name;
+    u32 hash;
+    /// Index into Definition::mSInstParams, or -1 if not resolved yet.
+    sead::Atomic<s32> index = -1;
+};
+
+/// The static parameter keys of one AI class.
+///
+/// Tables register themselves in a hash index (keyed on the definition type and class name hash)
+/// during static initialisation. The first time that AIProgram::parseDefParams sees a definition
+/// of the class, it resolves every slot from the AIClassDef, so loadParams_ finds parameters
+/// directly even for the first actor.
+class StaticParamSlotTable {
+public:
+    template <size_t N>
+    StaticParamSlotTable(AIDefType type, const char* class_name, StaticParamSlot (&slots)[N])
+        : StaticParamSlotTable(type, class_name, slots, s32(N)) {}
+
+    StaticParamSlotTable(AIDefType type, const char* class_name, StaticParamSlot* slots,
+                         s32 num_slots);
+
+    /// Resolves the slots of the table for the specified class, unless that has already been
+    /// done. `def` must be the static (SInst) definition of the class.
+    /// This does not take any lock: concurrent resolutions of a class store the same indices.
+    static void resolve(AIDefType type, const sead::SafeString& class_name, const AIDef& def);
+
+private:
+    static constexpr u32 NumBuckets = 0x800;
+
+    static u32 getBucketIdx(AIDefType type, u32 class_name_hash) {
+        return (class_name_hash ^ (u32(type) * 0x9e3779b9)) & (NumBuckets - 1);
+    }
+
+    /// Chained by mNext. Only written during static initialisation.
+    static StaticParamSlotTable* sBuckets[NumBuckets];
+
+    StaticParamSlotTable* mNext;
+    AIDefType mType;
+    const char* mClassName;
+    u32 mClassNameHash;
+    StaticParamSlot* mSlots;
+    s32 mNumSlots;
+    sead::Atomic<bool> mResolved = false;
+};
+
 struct Param {
     Param* next;
     u32 hash;
@@ -70,9 +128,29 @@ public:
     ParamPack();
     ~ParamPack();
 
+    static u32 calcHash(const sead::SafeString& key);
+
     template <typename T>
     T* getVariable(const sead::SafeString& key, AIDefParamType type, bool a4 = true) const;
 
+    /// Same as getVariable, but takes a key that has already been hashed with calcHash.
+    template <typename T>
+    T* getVariable(u32 hash, AIDefParamType type, bool a4 = true) const {
+        Param* param = resolveSlot(hash, type);
+        if (!param)
+            return nullptr;
+        if (a4)
+            param->used = true;
+        return static_cast<T*>(param->data);
+    }
+
+    /// Resolves a key to its parameter. The returned slot (and the value it points to) stays
+    /// valid until the pack is destroyed, so this only needs to be done once per key.
+    Param* resolveSlot(u32 hash, AIDefParamType type) const;
+    Param* resolveSlot(const sead::SafeString& key, AIDefParamType type) const {
+        return resolveSlot(calcHash(key), type);
+    }
+
     template <typename T>
     bool setVariable(const sead::SafeString& key, AIDefParamType type, const T& val) const {
         T* variable = getVariable<T>(key, type, true);
@@ -98,21 +176,22 @@ public:
     void getPairs(ParamNameTypePairs* pairs, bool update_use_count) const;
 
     template <typename T, AIDefParamType Type>
-    bool getPtrGeneric(T** value, const sead::SafeString& key) const {
-        auto* ptr = static_cast<T*>(getAITreeVariablePointer(key, Type));
+    bool getPtrGeneric(T** value, u32 hash) const {
+        auto* ptr = getVariable<T>(hash, Type, false);
         *value = ptr;
         return ptr != nullptr;
     }
 
     // TODO: rename this -- why does this exist?
     template <typename T, AIDefParamType Type>
-    bool getPtrGeneric2(T** value, const sead::SafeString& key) const {
-        auto* ptr = static_cast<T*>(getAITreeVariablePointer(key, Type));
+    bool getPtrGeneric2(T** value, u32 hash) const {
+        auto* ptr = getVariable<T>(hash, Type, false);
         *value = ptr;
         return ptr != nullptr;
     }
 
     bool getString(sead::SafeString* value, const sead::SafeString& key) const;
+    bool getStringByHash(sead::SafeString* value, u32 hash) const;
     bool setString(const sead::SafeString& value, const sead::SafeString& key) const;
 
     bool getActor(BaseProc* proc, const sead::SafeString& key) const;
@@ -121,7 +200,17 @@ public:
     bool load(const Actor& actor, const AIDef& def, sead::Heap* heap, AIDefInstParamKind kind);
 
 private:
-    Param* mParams = nullptr;
+    struct Storage;
+    struct TableEntry;
+
+    Param* findParam(u32 hash) const;
+    Param* getParams() const;
+
+    /// One block is allocated per load() call. It holds the new Param nodes and their values.
+    /// Older blocks are kept alive (and never moved) because pointers to their values may have
+    /// been handed out already. The newest block also owns the lookup table for every parameter
+    /// in the pack, which is reallocated only when it needs to grow.
+    Storage* mStorage = nullptr;
 };
 
 }  // namespace act::ai
@@ -5,9 +5,15 @@
 #include "KingSystem/ActorSystem/actAiQuery.h"
 #include "KingSystem/ActorSystem/queryDummyQuery.h"
 #include "KingSystem/Resource/Actor/resResourceAIProgram.h"
+#include "KingSystem/Utils/Container/PerfectHashTable.h"
 
 namespace ksys::act::ai {
 
+namespace {
+/// Maps name hashes to indices in Queries::sFactories.
+util::PerfectHashTable<0x100> sFactoryIndex;
+}  // namespace
+
 Queries::Queries() = default;
 
 Queries::~Queries() {
@@ -123,6 +129,11 @@ Query* Queries::getQuery(const sead::SafeString& name) const {
 
 QueryFactory* Queries::getFactory(const sead::SafeString& name) {
     const u32 name_hash = sead::HashCRC32::calcStringHash(name);
+    if (sFactoryIndex.isValid()) {
+        QueryFactory* factory = sFactories.get(sFactoryIndex.find(name_hash));
+        return factory->hash == name_hash ? factory : nullptr;
+    }
+
     const s32 idx = sFactories.binarySearch(
         name_hash, +[](const QueryFactory& factory, const u32& hash) {
             if (factory.hash < hash)
@@ -138,6 +149,7 @@ QueryFactory* Queries::getFactory(const sead::SafeString& name) {
 
 void Queries::setFactories(int count, QueryFactory* factories) {
     sFactories.setBuffer(count, factories);
+    sFactoryIndex.build(count, [factories](s32 i) { return factories[i].hash; });
 }
 
 sead::Buffer<QueryFactory> Queries::sFactories;
@@ -47,6 +47,17 @@ bool Query::getStaticParam(const f32** value, const sead::SafeString& param) con
     return getAIProg()->getSInstParam(value, def, param);
 }
 
+template <typename T>
+bool Query::getStaticParam(T* value, StaticParamSlot* slot) const {
+    const auto& def = getAIProg()->getQueries()[mDefIdx];
+    return getAIProg()->getSInstParam(value, def, slot);
+}
+
+template bool Query::getStaticParam(sead::SafeString*, StaticParamSlot*) const;
+template bool Query::getStaticParam(const s32**, StaticParamSlot*) const;
+template bool Query::getStaticParam(const f32**, StaticParamSlot*) const;
+template bool Query::getStaticParam(const bool**, StaticParamSlot*) const;
+
 bool Query::getDynamicParam(sead::SafeString* value, const sead::SafeString& param) const {
     if (mParamPack.getString(value, param))
         return true;
@@ -38,6 +38,9 @@ public:
     const char* getName() const;
 
     bool getStaticParam(const f32** value, const sead::SafeString& param) const;
+    /// Faster version for generated code: the key is pre-hashed and its index is cached.
+    template <typename T>
+    bool getStaticParam(T* value, StaticParamSlot* slot) const;
 
     bool getDynamicParam(sead::SafeString* value, const sead::SafeString& param) const;
     bool getDynamicParam(s32** value, const sead::SafeString& param) const;
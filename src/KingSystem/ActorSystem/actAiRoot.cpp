@@ -12,6 +12,8 @@ RootAi::RootAi(const InitArg& arg) : Ai(arg) {
 
 RootAi::~RootAi() {
     mQueries.finalize();
+    if (mActor)
+        mBehaviors.recordUsage(mActor);
     mBehaviors.finalize();
     mAis.finalize();
     mActions.finalize();
@@ -0,0 +1,292 @@
+#include "KingSystem/ActorSystem/actAiTrace.h"
+#include <algorithm>
+#include <codec/seadHashCRC32.h>
+#include <cstring>
+#include <filedevice/seadFileDeviceMgr.h>
+#include <heap/seadHeap.h>
+#include <math/seadMathCalcCommon.h>
+#include <thread/seadAtomic.h>
+#include <time/seadTickSpan.h>
+#include <time/seadTickTime.h>
+#include "KingSystem/ActorSystem/actActor.h"
+#include "KingSystem/ActorSystem/actAiActionBase.h"
+
+namespace ksys::act::ai {
+
+namespace {
+
+struct RawEvent {
+    u64 tick;
+    const char* class_name;
+    u32 actor_id;
+    u32 value;
+    Trace::EventType type;
+};
+
+/// Layout of events in trace files.
+struct FileEvent {
+    u64 tick;
+    u32 frame;
+    u32 actor_id;
+    u32 class_hash;
+    u32 value;
+    Trace::EventType type;
+    u8 thread_idx;
+    u8 reserved[6];
+};
+KSYS_CHECK_SIZE_NX150(FileEvent, 0x20);
+
+struct FileHeader {
+    u32 magic;
+    u32 version;
+    u64 tick_frequency;
+    u32 num_events;
+    u32 num_names;
+    u32 num_dropped_events;
+    u32 reserved;
+};
+KSYS_CHECK_SIZE_NX150(FileHeader, 0x20);
+
+/// Single-producer single-consumer event ring. Only the owning thread writes events;
+/// only the thread that calls Trace::onFrameEnd reads them.
+struct ThreadEventBuffer {
+    RawEvent* events;
+    u32 mask;
+    sead::Atomic<u32> write_idx;
+    sead::Atomic<u32> read_idx;
+    sead::Atomic<u32> num_dropped;
+};
+
+struct NameEntry {
+    u32 hash;
+    /// Offset of the name in the name buffer, or -1 if the entry is free.
+    s32 offset;
+};
+
+constexpr s32 MaxNames = 0x1000;
+
+struct TraceState {
+    sead::Heap* heap = nullptr;
+    u32 num_events_per_thread = 0;
+    ThreadEventBuffer buffers[Trace::MaxThreads]{};
+
+    FileEvent* captured_events = nullptr;
+    u32 max_captured_events = 0;
+    u32 num_captured_events = 0;
+    u32 num_dropped_events = 0;
+    u32 frame = 0;
+
+    char* names = nullptr;
+    u32 names_size = 0;
+    u32 names_used = 0;
+    NameEntry name_entries[MaxNames]{};
+    s32 num_names = 0;
+};
+
+TraceState sTrace;
+
+ThreadEventBuffer* getBufferForCurrentThread() {
+    const s32 slot = util::getCurrentThreadSlot();
+    if (slot < 0)
+        return nullptr;
+
+    auto& buffer = sTrace.buffers[slot];
+    if (!buffer.events) {
+        // Only this thread can allocate its own buffer.
+        buffer.mask = sTrace.num_events_per_thread - 1;
+        buffer.events = new (sTrace.heap, std::nothrow_t()) RawEvent[sTrace.num_events_per_thread];
+    }
+    return buffer.events ? &buffer : nullptr;
+}
+
+void record(Trace::EventType type, const char* class_name, const Actor* actor, u32 value) {
+    ThreadEventBuffer* buffer = getBufferForCurrentThread();
+    if (!buffer)
+        return;
+
+    const u32 write_idx = buffer->write_idx;
+    if (write_idx - buffer->read_idx > buffer->mask) {
+        buffer->num_dropped.increment();
+        return;
+    }
+
+    auto& event = buffer->events[write_idx & buffer->mask];
+    event.tick = sead::TickTime().toTicks();
+    event.class_name = class_name;
+    event.actor_id = actor ? actor->getId() : 0;
+    event.value = value;
+    event.type = type;
+    buffer->write_idx.increment();
+}
+
+void addName(u32 hash, const char* name) {
+    constexpr u32 Mask = MaxNames - 1;
+    for (u32 i = 0, idx = hash & Mask; i < MaxNames; ++i, idx = (idx + 1) & Mask) {
+        auto& entry = sTrace.name_entries[idx];
+        if (entry.offset >= 0 && entry.hash == hash)
+            return;
+        if (entry.offset >= 0)
+            continue;
+
+        const u32 size = u32(std::strlen(name)) + 1;
+        if (sTrace.names_used + size > sTrace.names_size)
+            return;
+        std::memcpy(sTrace.names + sTrace.names_used, name, size);
+        entry.hash = hash;
+        entry.offset = s32(sTrace.names_used);
+        sTrace.names_used += size;
+        ++sTrace.num_names;
+        return;
+    }
+}
+
+/// Names are hashed when events are drained, at most one frame after they were recorded,
+/// so the AIProgram that owns the string is still loaded. The hash is always computed from the
+/// contents: an AIProgram can be unloaded and another one loaded at the same address, so the
+/// pointer does not identify the name.
+u32 getClassHash(const char* name) {
+    if (!name)
+        return 0;
+
+    const u32 hash = sead::HashCRC32::calcStringHash(name);
+    addName(hash, name);
+    return hash;
+}
+
+void resetCapture() {
+    sTrace.num_captured_events = 0;
+    sTrace.num_dropped_events = 0;
+    sTrace.names_used = 0;
+    sTrace.num_names = 0;
+    for (auto& entry : sTrace.name_entries)
+        entry.offset = -1;
+}
+
+}  // namespace
+
+bool Trace::sEnabled = false;
+
+bool Trace::init(const InitArg& arg, sead::Heap* heap) {
+    if (sTrace.heap || !sead::Mathu::isPow2(arg.num_events_per_thread))
+        return false;
+
+    sTrace.captured_events = new (heap, std::nothrow_t()) FileEvent[arg.num_captured_events];
+    sTrace.names = new (heap, std::nothrow_t()) char[arg.name_buffer_size];
+    if (!sTrace.captured_events || !sTrace.names) {
+        delete[] sTrace.captured_events;
+        delete[] sTrace.names;
+        sTrace.captured_events = nullptr;
+        sTrace.names = nullptr;
+        return false;
+    }
+
+    sTrace.num_events_per_thread = arg.num_events_per_thread;
+    sTrace.max_captured_events = arg.num_captured_events;
+    sTrace.names_size = arg.name_buffer_size;
+    resetCapture();
+    sTrace.heap = heap;
+    return true;
+}
+
+void Trace::start() {
+    if (!sTrace.heap)
+        return;
+    resetCapture();
+    sEnabled = true;
+}
+
+void Trace::stop() {
+    sEnabled = false;
+}
+
+void Trace::recordEnter(const ActionBase* node) {
+    record(EventType::Enter, node->getClassName(), node->getActor(), 0);
+}
+
+void Trace::recordLeave(const ActionBase* node) {
+    record(EventType::Leave, node->getClassName(), node->getActor(), 0);
+}
+
+void Trace::recordCalc(const ActionBase* node, u64 ticks) {
+    record(EventType::Calc, node->getClassName(), node->getActor(),
+           u32(std::min<u64>(ticks, 0xffffffff)));
+}
+
+void Trace::onFrameEnd() {
+    if (!sTrace.heap)
+        return;
+
+    const s32 num_buffers = util::getNumThreadSlots();
+    for (s32 i = 0; i < num_buffers; ++i) {
+        auto& buffer = sTrace.buffers[i];
+        if (!buffer.events)
+            continue;
+
+        const u32 write_idx = buffer.write_idx;
+        for (u32 idx = buffer.read_idx; idx != write_idx; ++idx) {
+            if (sTrace.num_captured_events >= sTrace.max_captured_events) {
+                ++sTrace.num_dropped_events;
+                continue;
+            }
+
+            const RawEvent& raw = buffer.events[idx & buffer.mask];
+            auto& event = sTrace.captured_events[sTrace.num_captured_events++];
+            event = {};
+            event.tick = raw.tick;
+            event.frame = sTrace.frame;
+            event.actor_id = raw.actor_id;
+            event.class_hash = getClassHash(raw.class_name);
+            event.value = raw.value;
+            event.type = raw.type;
+            event.thread_idx = u8(i);
+        }
+
+        sTrace.num_dropped_events += buffer.num_dropped.exchange(0);
+        buffer.read_idx = write_idx;
+    }
+
+    ++sTrace.frame;
+}
+
+u32 Trace::getNumCapturedEvents() {
+    return sTrace.num_captured_events;
+}
+
+u32 Trace::getNumDroppedEvents() {
+    return sTrace.num_dropped_events;
+}
+
+bool Trace::writeFile(const sead::SafeString& path) {
+    sead::FileHandle handle;
+    if (!sead::FileDeviceMgr::instance()->tryOpen(&handle, path,
+                                                   sead::FileDevice::cFileOpenFlag_WriteOnly)) {
+        return false;
+    }
+
+    FileHeader header{};
+    header.magic = FileMagic;
+    header.version = FileVersion;
+    header.tick_frequency = u64(sead::TickSpan::fromSeconds(1).toTicks());
+    header.num_events = sTrace.num_captured_events;
+    header.num_names = u32(sTrace.num_names);
+    header.num_dropped_events = sTrace.num_dropped_events;
+    handle.write(reinterpret_cast<const u8*>(&header), sizeof(header));
+
+    handle.write(reinterpret_cast<const u8*>(sTrace.captured_events),
+                 u32(sizeof(FileEvent) * sTrace.num_captured_events));
+
+    // Name table: for each name, the hash, the length and the characters (no terminator).
+    for (const auto& entry : sTrace.name_entries) {
+        if (entry.offset < 0)
+            continue;
+        const char* name = sTrace.names + entry.offset;
+        const u32 length = u32(std::strlen(name));
+        handle.write(reinterpret_cast<const u8*>(&entry.hash), sizeof(entry.hash));
+        handle.write(reinterpret_cast<const u8*>(&length), sizeof(length));
+        handle.write(reinterpret_cast<const u8*>(name), length);
+    }
+
+    return true;
+}
+
+}  // namespace ksys::act::ai
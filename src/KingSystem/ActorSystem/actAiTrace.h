@@ -0,0 +1,70 @@
+#pragma once
+
+#include <basis/seadTypes.h>
+#include <prim/seadSafeString.h>
+#include "KingSystem/Utils/Thread/ThreadSlot.h"
+#include "KingSystem/Utils/Types.h"
+
+namespace sead {
+class Heap;
+}
+
+namespace ksys::act::ai {
+
+class ActionBase;
+
+/// Records AI decisions (action enter/leave) and per-node calc times.
+///
+/// Events are written into per-thread rings without taking any lock and are drained once per
+/// frame into a capture buffer, which can be saved as a compact binary file and decoded offline
+/// with tools/ai_trace_decode.py. Class names are stored as CRC32 hashes; the file includes a
+/// table that maps each hash back to its name.
+///
+/// When recording is disabled, each hook costs a single branch on isEnabled().
+class Trace {
+public:
+    static constexpr s32 MaxThreads = util::MaxThreadSlots;
+    static constexpr u32 FileMagic = 0x52544941;  // "AITR"
+    static constexpr u32 FileVersion = 2;
+
+    enum class EventType : u8 {
+        Enter = 0,
+        Leave = 1,
+        /// `value` is the time spent in the node's own calc, in ticks.
+        Calc = 2,
+    };
+
+    struct InitArg {
+        /// Must be a power of 2.
+        u32 num_events_per_thread = 0x800;
+        u32 num_captured_events = 0x40000;
+        /// Size of the buffer that stores the class names referenced by captured events.
+        u32 name_buffer_size = 0x10000;
+    };
+
+    static bool init(const InitArg& arg, sead::Heap* heap);
+
+    static bool isEnabled() { return sEnabled; }
+    /// Starts recording into a new capture.
+    static void start();
+    static void stop();
+
+    static void recordEnter(const ActionBase* node);
+    static void recordLeave(const ActionBase* node);
+    static void recordCalc(const ActionBase* node, u64 ticks);
+
+    /// Moves recorded events to the capture buffer. Must be called from a single thread
+    /// once per frame.
+    static void onFrameEnd();
+
+    static u32 getNumCapturedEvents();
+    static u32 getNumDroppedEvents();
+
+    /// Writes the capture to the specified file. See tools/ai_trace_decode.py for the format.
+    static bool writeFile(const sead::SafeString& path);
+
+private:
+    static bool sEnabled;
+};
+
+}  // namespace ksys::act::ai
@@ -1,6 +1,9 @@
 #include "KingSystem/ActorSystem/actBaseProcJob.h"
+#include <thread/seadThread.h>
 #include "KingSystem/ActorSystem/actBaseProcMgr.h"
+#include "KingSystem/System/Profiler.h"
 #include "KingSystem/Utils/InitTimeInfo.h"
+#include "KingSystem/Utils/Thread/ThreadSlot.h"
 
 namespace ksys::act {
 
@@ -76,6 +79,9 @@ sead::TListNode<BaseProc*>* BaseProcJobLists::getNextJob(BaseProcJobLink* link)
 }
 
 void BaseProcJob::invoke() {
+    // Jobs run on the sead worker threads, which are not created by KingSystem.
+    util::markJobThread(sead::ThreadMgr::instance()->getCurrentThread());
+    KSYS_PROFILE_SCOPE("BaseProcJob::invoke");
     BaseProcMgr::instance()->jobInvoked(mJobLink, mRequiredCalcRounds);
 }
 
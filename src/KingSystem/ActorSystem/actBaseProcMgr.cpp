@@ -2,13 +2,16 @@
 #include <mc/seadWorkerMgr.h>
 #include <prim/seadScopedLock.h>
 #include <thread/seadThread.h>
+#include "KingSystem/ActorSystem/actActorLimiter.h"
 #include "KingSystem/ActorSystem/actActorSystem.h"
+#include "KingSystem/ActorSystem/actAiTrace.h"
 #include "KingSystem/ActorSystem/actBaseProcDeleter.h"
 #include "KingSystem/ActorSystem/actBaseProcHeapMgr.h"
 #include "KingSystem/ActorSystem/actBaseProcInitializer.h"
 #include "KingSystem/ActorSystem/actBaseProcJobHandler.h"
 #include "KingSystem/ActorSystem/actBaseProcJobQue.h"
 #include "KingSystem/ActorSystem/actBaseProcLink.h"
+#include "KingSystem/System/Profiler.h"
 
 namespace ksys::act {
 
@@ -299,6 +302,10 @@ void BaseProcMgr::removeSpecialJobTypes(u16 mask) {
 }
 
 void BaseProcMgr::calc() {
+    KSYS_PROFILE_SCOPE("BaseProcMgr::calc");
+    ai::Trace::onFrameEnd();
+    if (auto* limiter = ActorLimiter::instance())
+        limiter->calc();
     ActorSystem::instance()->onBaseProcMgrCalc();
     mProcInitializer->deleteThreadIfPaused();
 
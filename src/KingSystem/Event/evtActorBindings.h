@@ -26,6 +26,7 @@ public:
 
     int isInitialized() const { return mInitialized; }
     int getNumBindings() const { return mBindings.size(); }
+    ActorBinding* getBinding(int idx) const { return mBindings[idx]; }
 
 private:
     sead::PtrArray<ActorBinding> mBindings;
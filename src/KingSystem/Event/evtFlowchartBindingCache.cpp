@@ -0,0 +1,167 @@
+#include "KingSystem/Event/evtFlowchartBindingCache.h"
+#include <cstring>
+#include <heap/seadExpHeap.h>
+#include "KingSystem/Event/evtActorBinding.h"
+#include "KingSystem/Event/evtActorBindings.h"
+
+namespace ksys::evt {
+
+SEAD_SINGLETON_DISPOSER_IMPL(FlowchartBindingCache)
+
+FlowchartBindingCache::FlowchartBindingCache() = default;
+
+// Plans are allocated from mHeap and are freed along with it.
+FlowchartBindingCache::~FlowchartBindingCache() = default;
+
+bool FlowchartBindingCache::init(sead::Heap* heap, u32 max_size) {
+    // Plans are added and warm-up builds are done on the resource loading thread, so the heap
+    // needs a lock. Leave some room for the block headers of every plan.
+    mHeap = sead::ExpHeap::create(max_size + MaxPlans * 0x40 + WarmUpHeapSize,
+                                  "FlowchartBindingCache", heap, sizeof(void*),
+                                  sead::Heap::cHeapDirection_Forward, true);
+    if (!mHeap)
+        return false;
+    mMaxSize = max_size;
+    return true;
+}
+
+sead::Heap* FlowchartBindingCache::getHeap() const {
+    return mHeap;
+}
+
+FlowchartBindingCache::Entry* FlowchartBindingCache::findEntry(const Key& key) {
+    for (s32 i = 0; i < mNumEntries; ++i) {
+        auto& entry = mEntries[i];
+        if (entry.entry_point_hash != key.entry_point_hash)
+            continue;
+        if (entry.plan.num_files != key.num_files || entry.entry_point != key.entry_point)
+            continue;
+        if (std::memcmp(entry.plan.files, key.files, sizeof(key.files[0]) * key.num_files) != 0)
+            continue;
+        return &entry;
+    }
+    return nullptr;
+}
+
+void FlowchartBindingCache::evictEntry(s32 idx) {
+    mTotalSize -= mEntries[idx].size;
+    delete[] mEntries[idx].block;
+    mEntries[idx] = mEntries[--mNumEntries];
+    mEntries[mNumEntries] = {};
+}
+
+bool FlowchartBindingCache::hasPlan(const Key& key) {
+    const auto lock = sead::makeScopedLock(mCritSection);
+    return findEntry(key) != nullptr;
+}
+
+bool FlowchartBindingCache::addPlan(const Key& key, const ActorBindings& bindings) {
+    if (!mHeap || key.num_files <= 0 || key.num_files > MaxFiles)
+        return false;
+
+    using Actor = FlowchartBindingPlan::Actor;
+
+    const s32 num_actors = bindings.getNumBindings();
+    s32 num_actions = 0;
+    s32 num_queries = 0;
+    for (s32 i = 0; i < num_actors; ++i) {
+        num_actions += bindings.getBinding(i)->getActions().size();
+        num_queries += bindings.getBinding(i)->getQueries().size();
+    }
+    // Indices are stored as u16.
+    if (num_actions > 0xffff || num_queries > 0xffff)
+        return false;
+
+    const u32 files_offset = 0;
+    const u32 actors_offset = files_offset + sizeof(key.files[0]) * key.num_files;
+    const u32 actions_offset = actors_offset + sizeof(Actor) * num_actors;
+    const u32 queries_offset = actions_offset + sizeof(evfl::ResAction*) * num_actions;
+    const u32 size = queries_offset + sizeof(evfl::ResQuery*) * num_queries;
+    if (size > mMaxSize)
+        return false;
+
+    const auto lock = sead::makeScopedLock(mCritSection);
+
+    if (findEntry(key))
+        return true;
+
+    // Evict the least recently used plans until the new one fits.
+    while (mNumEntries != 0 && (mNumEntries == MaxPlans || mTotalSize + size > mMaxSize)) {
+        s32 lru_idx = 0;
+        for (s32 i = 1; i < mNumEntries; ++i) {
+            if (mEntries[i].last_use < mEntries[lru_idx].last_use)
+                lru_idx = i;
+        }
+        evictEntry(lru_idx);
+        ++mStats.num_evicted;
+    }
+
+    auto* block = new (mHeap, 8, std::nothrow_t()) u8[size];
+    if (!block)
+        return false;
+
+    auto* files = reinterpret_cast<const evfl::ResEventFlowFile**>(block + files_offset);
+    auto* actors = reinterpret_cast<Actor*>(block + actors_offset);
+    auto* actions = reinterpret_cast<const evfl::ResAction**>(block + actions_offset);
+    auto* queries = reinterpret_cast<const evfl::ResQuery**>(block + queries_offset);
+
+    for (s32 i = 0; i < key.num_files; ++i)
+        files[i] = key.files[i];
+
+    s32 action_idx = 0;
+    s32 query_idx = 0;
+    for (s32 i = 0; i < num_actors; ++i) {
+        const auto* binding = bindings.getBinding(i);
+        auto& actor = actors[i];
+        actor.res = binding->getRes();
+        actor.first_action = u16(action_idx);
+        actor.num_actions = u16(binding->getActions().size());
+        actor.first_query = u16(query_idx);
+        actor.num_queries = u16(binding->getQueries().size());
+
+        for (s32 j = 0; j < actor.num_actions; ++j)
+            actions[action_idx++] = binding->getActions()[j];
+        for (s32 j = 0; j < actor.num_queries; ++j)
+            queries[query_idx++] = binding->getQueries()[j];
+    }
+
+    auto& entry = mEntries[mNumEntries++];
+    entry.block = block;
+    entry.plan.files = files;
+    entry.plan.num_files = key.num_files;
+    entry.plan.actors = actors;
+    entry.plan.num_actors = num_actors;
+    entry.plan.actions = actions;
+    entry.plan.queries = queries;
+    entry.entry_point = key.entry_point;
+    entry.entry_point_hash = key.entry_point_hash;
+    entry.size = size;
+    entry.last_use = ++mUseCounter;
+    mTotalSize += size;
+    return true;
+}
+
+void FlowchartBindingCache::invalidate(const evfl::ResEventFlowFile* file) {
+    const auto lock = sead::makeScopedLock(mCritSection);
+
+    for (s32 i = 0; i < mNumEntries;) {
+        const auto& plan = mEntries[i].plan;
+        bool uses_file = false;
+        for (s32 j = 0; j < plan.num_files; ++j) {
+            if (plan.files[j] == file) {
+                uses_file = true;
+                break;
+            }
+        }
+
+        if (uses_file) {
+            // evictEntry moves the last entry to this index, so do not advance.
+            evictEntry(i);
+            ++mStats.num_invalidated;
+        } else {
+            ++i;
+        }
+    }
+}
+
+}  // namespace ksys::evt
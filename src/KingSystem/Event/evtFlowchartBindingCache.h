@@ -0,0 +1,144 @@
+#pragma once
+
+#include <basis/seadTypes.h>
+#include <container/seadSafeArray.h>
+#include <heap/seadDisposer.h>
+#include <prim/seadSafeString.h>
+#include <prim/seadScopedLock.h>
+#include <thread/seadCriticalSection.h>
+
+namespace sead {
+class ExpHeap;
+}
+
+namespace evfl {
+struct ResAction;
+struct ResActor;
+struct ResEventFlowFile;
+struct ResQuery;
+}  // namespace evfl
+
+namespace ksys::evt {
+
+class ActorBindings;
+
+/// Resolved actor, action and query bindings for a flowchart entry point.
+///
+/// A plan is the result of running the EventFlow binders over a built flowchart context:
+/// the list of bound actors (in binding order) and the actions and queries of each actor.
+/// All pointers point into the flowchart resources, so a plan is only valid for as long as
+/// the resources it was built from are loaded.
+struct FlowchartBindingPlan {
+    struct Actor {
+        const evfl::ResActor* res;
+        u16 first_action;
+        u16 num_actions;
+        u16 first_query;
+        u16 num_queries;
+    };
+
+    const evfl::ResEventFlowFile* const* files;
+    s32 num_files;
+    const Actor* actors;
+    s32 num_actors;
+    const evfl::ResAction* const* actions;
+    const evfl::ResQuery* const* queries;
+};
+
+/// Keeps the bindings of recently started flowcharts so that starting an event again does not
+/// require building a flowchart context and resolving every actor, action and query again.
+///
+/// Plans are keyed by the flowchart files they were built from (the main flowchart first)
+/// and by the entry point name. Plans are removed when any of their files is unloaded;
+/// the least recently used plans are evicted when the cache is full.
+class FlowchartBindingCache {
+    SEAD_SINGLETON_DISPOSER(FlowchartBindingCache)
+    FlowchartBindingCache();
+    virtual ~FlowchartBindingCache();
+
+public:
+    static constexpr s32 MaxPlans = 0x80;
+    static constexpr s32 MaxFiles = 32;
+    /// Extra space for the flowchart contexts and bindings that warm-ups build.
+    static constexpr u32 WarmUpHeapSize = 0x40000;
+
+    struct Key {
+        const evfl::ResEventFlowFile* const* files;
+        s32 num_files;
+        const char* entry_point;
+        u32 entry_point_hash;
+    };
+
+    struct Stats {
+        u32 num_hits;
+        u32 num_misses;
+        u32 num_invalidated;
+        u32 num_evicted;
+    };
+
+    /// Creates the heap that plans are allocated from as a child of `heap`.
+    /// @param max_size Maximum total size of all plans.
+    bool init(sead::Heap* heap, u32 max_size);
+
+    /// @return the heap that plans are allocated from; also used for warm-up builds.
+    sead::Heap* getHeap() const;
+
+    /// Calls `fn(plan)` with the plan for the specified key, while the cache is locked so that
+    /// the plan cannot be evicted or invalidated.
+    /// @return whether a plan was found.
+    template <typename Function>
+    bool withPlan(const Key& key, const Function& fn);
+
+    /// @return whether there is a plan for the specified key.
+    bool hasPlan(const Key& key);
+
+    /// Records the bindings in `bindings` as the plan for the specified key.
+    /// `bindings` must only contain bindings that were set up from that key's files.
+    bool addPlan(const Key& key, const ActorBindings& bindings);
+
+    /// Removes every plan that refers to the specified file. Must be called before the file
+    /// is unloaded or relocated.
+    void invalidate(const evfl::ResEventFlowFile* file);
+
+    const Stats& getStats() const { return mStats; }
+
+private:
+    struct Entry {
+        u8* block;
+        FlowchartBindingPlan plan;
+        sead::FixedSafeString<128> entry_point;
+        u32 entry_point_hash;
+        u32 size;
+        u32 last_use;
+    };
+
+    Entry* findEntry(const Key& key);
+    void evictEntry(s32 idx);
+
+    sead::ExpHeap* mHeap = nullptr;
+    sead::CriticalSection mCritSection;
+    sead::SafeArray<Entry, MaxPlans> mEntries{};
+    s32 mNumEntries = 0;
+    u32 mMaxSize = 0;
+    u32 mTotalSize = 0;
+    u32 mUseCounter = 0;
+    Stats mStats{};
+};
+
+template <typename Function>
+inline bool FlowchartBindingCache::withPlan(const Key& key, const Function& fn) {
+    const auto lock = sead::makeScopedLock(mCritSection);
+
+    Entry* entry = findEntry(key);
+    if (!entry) {
+        ++mStats.num_misses;
+        return false;
+    }
+
+    ++mStats.num_hits;
+    entry->last_use = ++mUseCounter;
+    fn(static_cast<const FlowchartBindingPlan&>(entry->plan));
+    return true;
+}
+
+}  // namespace ksys::evt
@@ -2,6 +2,7 @@
 #include <basis/seadNew.h>
 #include <prim/seadSafeString.h>
 #include <resource/seadResource.h>
+#include "KingSystem/Event/evtFlowchartBindingCache.h"
 #include "KingSystem/Resource/resHandle.h"
 #include "KingSystem/Resource/resLoadRequest.h"
 #include "KingSystem/Utils/Byaml/Byaml.h"
@@ -14,6 +15,11 @@ InfoData::InfoData() = default;
 
 void InfoData::init(sead::Heap* heap) {
     doInit(heap, nullptr);
+
+    if (!FlowchartBindingCache::instance()) {
+        FlowchartBindingCache::createInstance(heap);
+        FlowchartBindingCache::instance()->init(heap, 0x40000);
+    }
 }
 
 void InfoData::doInit(sead::Heap* heap, OverlayArena* arena) {
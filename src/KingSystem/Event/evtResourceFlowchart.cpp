@@ -1,7 +1,9 @@
 #include "KingSystem/Event/evtResourceFlowchart.h"
 #include <array>
+#include <codec/seadHashCRC32.h>
 #include <evfl/Flowchart.h>
 #include <evfl/ResEventFlowFile.h>
+#include "KingSystem/Event/evtActorBinding.h"
 #include "KingSystem/Event/evtActorBindings.h"
 #include "KingSystem/Event/evtEventResource.h"
 #include "KingSystem/Event/evtInfoData.h"
@@ -11,6 +13,7 @@
 #include "KingSystem/Resource/resResourceMgrTask.h"
 #include "KingSystem/Utils/Byaml/Byaml.h"
 #include "KingSystem/Utils/HeapUtil.h"
+#include "KingSystem/Utils/SafeDelete.h"
 
 namespace ksys::evt {
 
@@ -19,6 +22,9 @@ ResourceFlowchart::ResourceFlowchart() {
 }
 
 ResourceFlowchart::~ResourceFlowchart() {
+    cancelWarmUp();
+    util::safeDelete(mWarmUpTask);
+
     for (int i = 0; i < mFlowcharts.size(); ++i)
         mFlowcharts[i].handle.requestUnload2();
 
@@ -43,6 +49,12 @@ void ResourceFlowchart::loadEventFlow(sead::Heap* heap, res::Handle* pack_handle
 
     mFlowcharts.allocBufferAssert(num_flowcharts, heap);
 
+    mWarmUpRequested = false;
+    if (FlowchartBindingCache::instance() && !mWarmUpTask) {
+        mWarmUpFn.bind(this, &ResourceFlowchart::warmUp_);
+        mWarmUpTask = new (heap) util::Task(heap);
+    }
+
     res::LoadRequest request;
     request.mRequester = "ResourceFlowchart";
     request.mPackHandle = pack_handle;
@@ -94,6 +106,9 @@ bool ResourceFlowchart::finishLoad() {
             ready = false;
     }
 
+    if (ready && !mLoadFailed)
+        requestWarmUp();
+
     return ready;
 }
 
@@ -163,11 +178,8 @@ long bindActorQueries(evfl::FlowchartContext& context, res::EventFlowQueryBinder
     return (int(any_failed) << 8) | int(any_ok);
 }
 
-bool ResourceFlowchart::setUpBindings(ActorBindings* bindings, sead::Heap* heap) {
-    evfl::FlowchartContext context;
-    if (!buildFlowchart(&context, heap))
-        return false;
-
+static void bindContext(evfl::FlowchartContext& context, ActorBindings* bindings,
+                        sead::Heap* heap) {
     // Bind actors. We do it twice: once in order to figure out how many actor bindings
     // need to be allocated, and a second time to actually bind actors.
     const auto bind_actors = [&] {
@@ -207,10 +219,164 @@ bool ResourceFlowchart::setUpBindings(ActorBindings* bindings, sead::Heap* heap)
     bindActorQueries(context, query_binder_2);
 
     context.UnbindAll();
+}
+
+// Goes through the same count, allocate and bind sequence as bindContext so that the bindings
+// end up identical to the ones the plan was recorded from.
+static void applyPlan(const FlowchartBindingPlan& plan, ActorBindings* bindings,
+                      sead::Heap* heap) {
+    for (s32 i = 0; i < plan.num_actors; ++i)
+        bindings->bindActor(plan.actors[i].res, heap);
+    bindings->allocBindings(heap);
+    for (s32 i = 0; i < plan.num_actors; ++i)
+        bindings->bindActor(plan.actors[i].res, heap);
+
+    const auto bind_actions = [&] {
+        for (s32 i = 0; i < plan.num_actors; ++i) {
+            const auto& actor = plan.actors[i];
+            for (s32 j = 0; j < actor.num_actions; ++j)
+                bindings->getBinding(i)->bindAction(plan.actions[actor.first_action + j]);
+        }
+    };
+    bind_actions();
+    bindings->allocBindingsActions(heap);
+    bind_actions();
+
+    const auto bind_queries = [&] {
+        for (s32 i = 0; i < plan.num_actors; ++i) {
+            const auto& actor = plan.actors[i];
+            for (s32 j = 0; j < actor.num_queries; ++j)
+                bindings->getBinding(i)->bindQuery(plan.queries[actor.first_query + j]);
+        }
+    };
+    bind_queries();
+    bindings->allocBindingsQueries(heap);
+    bind_queries();
+}
+
+bool ResourceFlowchart::setUpBindings(ActorBindings* bindings, sead::Heap* heap) {
+    auto* cache = FlowchartBindingCache::instance();
+    FlowchartBindingCache::Key key;
+    std::array<const evfl::ResEventFlowFile*, FlowchartBindingCache::MaxFiles> files;
+    // Plans can only be applied to (and recorded from) bindings that start out empty.
+    const bool use_cache =
+        cache && bindings->getNumBindings() == 0 && getCacheKey(&key, files.data());
+
+    if (use_cache) {
+        finishWarmUp();
+        const bool found = cache->withPlan(key, [&](const FlowchartBindingPlan& plan) {
+            applyPlan(plan, bindings, heap);
+        });
+        if (found)
+            return bindings->getNumBindings() != 0;
+    }
+
+    evfl::FlowchartContext context;
+    if (!buildFlowchart(&context, heap))
+        return false;
+
+    bindContext(context, bindings, heap);
+
+    // If missing flowcharts had to be loaded, the bindings refer to files that are not part of
+    // the key and that the cache would not be notified about when they are unloaded.
+    if (use_cache && !mMissingFlowcharts.isBufferReady())
+        cache->addPlan(key, *bindings);
 
     return bindings->getNumBindings() != 0;
 }
 
+bool ResourceFlowchart::buildLoadedFlowcharts(evfl::FlowchartContext* context,
+                                              sead::Heap* heap) {
+    std::array<const evfl::ResFlowchart*, 32> flowcharts;
+    const int num_flowcharts = mFlowcharts.size();
+    if (num_flowcharts > int(flowcharts.size()))
+        return false;
+
+    for (int i = 0; i < num_flowcharts; ++i)
+        flowcharts[i] = mFlowcharts[i].res_flowchart;
+
+    evfl::FlowchartContext::Builder builder({flowcharts.data(), num_flowcharts});
+    if (!builder.SetEntryPoint(mName.cstr(), mEntryPoint.cstr()))
+        return false;
+
+    evfl::FlowchartContext::Builder::BuildResult result;
+    return builder.Build(&result, context, makeEvflAllocateArg(heap));
+}
+
+bool ResourceFlowchart::getCacheKey(FlowchartBindingCache::Key* key,
+                                    const evfl::ResEventFlowFile** files) const {
+    const int num_files = mFlowcharts.size();
+    if (mLoadFailed || num_files == 0 || num_files > FlowchartBindingCache::MaxFiles)
+        return false;
+
+    for (int i = 0; i < num_files; ++i) {
+        if (!mFlowcharts[i].loaded || !mFlowcharts[i].res_event_flow_file)
+            return false;
+        files[i] = mFlowcharts[i].res_event_flow_file;
+    }
+
+    key->files = files;
+    key->num_files = num_files;
+    key->entry_point = mEntryPoint.cstr();
+    key->entry_point_hash = sead::HashCRC32::calcStringHash(mEntryPoint.cstr());
+    return true;
+}
+
+void ResourceFlowchart::requestWarmUp() {
+    auto* mgr = res::ResourceMgrTask::instance();
+    if (mWarmUpRequested || !mWarmUpTask || !mgr || !FlowchartBindingCache::instance())
+        return;
+
+    mWarmUpRequested = true;
+    if (!mWarmUpTask->canSubmitRequest())
+        return;
+
+    util::TaskRequest req;
+    req.mHasHandle = false;
+    req.mSynchronous = false;
+    req.mLaneId = u8(res::ResourceMgrTask::LaneId::_7);
+    req.mThread = mgr->getResourceLoadingThread();
+    req.mDelegate = &mWarmUpFn;
+    req.mName = "ResourceFlowchart::warmUp";
+    mWarmUpTask->submitRequest(req);
+}
+
+void ResourceFlowchart::finishWarmUp() {
+    auto* mgr = res::ResourceMgrTask::instance();
+    if (!mWarmUpRequested || !mWarmUpTask || !mgr)
+        return;
+
+    // This waits for the warm-up if it is already running. If it is still queued, it is taken
+    // off the queue and run here instead, so that its plan is available either way.
+    mWarmUpTask->removeFromQueue2();
+    if (mWarmUpTask->getStatus() == util::Task::Status::RemovedFromQueue)
+        mWarmUpTask->processOnCurrentThreadDirectly(mgr->getResourceLoadingThread());
+}
+
+void ResourceFlowchart::cancelWarmUp() {
+    // Waits for the warm-up to finish if it is already running.
+    if (mWarmUpTask)
+        mWarmUpTask->removeFromQueue();
+}
+
+bool ResourceFlowchart::warmUp_(void*) {
+    auto* cache = FlowchartBindingCache::instance();
+    FlowchartBindingCache::Key key;
+    std::array<const evfl::ResEventFlowFile*, FlowchartBindingCache::MaxFiles> files;
+    if (!cache || !getCacheKey(&key, files.data()) || cache->hasPlan(key))
+        return true;
+
+    // Missing flowcharts cannot be loaded from this thread, so only the loaded files are used.
+    sead::Heap* heap = cache->getHeap();
+    evfl::FlowchartContext context;
+    if (!buildLoadedFlowcharts(&context, heap))
+        return false;
+
+    ActorBindings bindings;
+    bindContext(context, &bindings, heap);
+    return cache->addPlan(key, bindings);
+}
+
 bool ResourceFlowchart::buildFlowchart(evfl::FlowchartContext* context, sead::Heap* heap) {
     std::array<const evfl::ResFlowchart*, 32> flowcharts;
     int num_flowcharts = 0;
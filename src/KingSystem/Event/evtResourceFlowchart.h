@@ -2,7 +2,9 @@
 
 #include <container/seadBuffer.h>
 #include <prim/seadSafeString.h>
+#include "KingSystem/Event/evtFlowchartBindingCache.h"
 #include "KingSystem/Resource/resHandle.h"
+#include "KingSystem/Utils/Thread/Task.h"
 
 namespace evfl {
 class FlowchartContext;
@@ -23,8 +25,13 @@ public:
     void loadEventFlow(sead::Heap* heap, res::Handle* pack_handle);
 
     /// @return true if the load completed (succeeded or failed), false if it is still ongoing.
+    /// Once every flowchart has been loaded, bindings are warmed up on the resource loading
+    /// thread if the binding cache is enabled.
     bool finishLoad();
 
+    /// Uses a cached binding plan if there is one for this flowchart and entry point;
+    /// otherwise builds the flowchart, binds it and caches the result.
+    /// A pending warm-up is finished first so that its plan can be used.
     /// @return whether at least one actor was bound.
     bool setUpBindings(ActorBindings* bindings, sead::Heap* heap);
 
@@ -41,11 +48,27 @@ private:
         bool loaded;
     };
 
+    /// Builds a context from mFlowcharts only, without loading missing flowcharts.
+    bool buildLoadedFlowcharts(evfl::FlowchartContext* context, sead::Heap* heap);
+
+    /// @param files Must be able to hold FlowchartBindingCache::MaxFiles entries.
+    /// @return whether the bindings for this flowchart can be cached.
+    bool getCacheKey(FlowchartBindingCache::Key* key, const evfl::ResEventFlowFile** files) const;
+
+    void requestWarmUp();
+    /// Waits for the warm-up, or runs it on the current thread if it has not started yet.
+    void finishWarmUp();
+    void cancelWarmUp();
+    bool warmUp_(void* userdata);
+
     sead::Buffer<Res> mFlowcharts;
     sead::Buffer<Res> mMissingFlowcharts;
     bool mLoadFailed;
     sead::FixedSafeString<64> mName;
     sead::FixedSafeString<128> mEntryPoint;
+    util::Task* mWarmUpTask = nullptr;
+    util::TaskDelegateT<ResourceFlowchart> mWarmUpFn;
+    bool mWarmUpRequested = false;
 };
 
 }  // namespace ksys::evt
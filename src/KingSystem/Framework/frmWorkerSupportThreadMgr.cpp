@@ -7,6 +7,7 @@
 #include "KingSystem/Utils/Thread/ManagedTask.h"
 #include "KingSystem/Utils/Thread/ManagedTaskHandle.h"
 #include "KingSystem/Utils/Thread/TaskMgr.h"
+#include "KingSystem/Utils/Thread/ThreadSlot.h"
 
 namespace ksys::frm {
 
@@ -43,6 +44,7 @@ void WorkerSupportThreadMgr::init(sead::Heap* heap) {
         worker->task_thread->init(arg);
         worker->task_thread->setAffinity(affinity);
         worker->task_thread->start();
+        util::markJobThread(worker->task_thread);
         ++worker;
     }
 
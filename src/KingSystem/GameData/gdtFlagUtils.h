@@ -136,6 +136,24 @@ inline void getVec4f(FlagHandle handle, sead::Vector4f* value, s32 idx, bool deb
         mgr->getVec4f(handle, value, idx, debug);
 }
 
+/// Reads `count` elements of an array flag, starting at element `first`.
+/// @return the number of elements that were read.
+inline s32 getBoolSpan(FlagHandle handle, bool* values, s32 first, s32 count, bool debug = false) {
+    auto* mgr = Manager::instance();
+    return mgr ? mgr->getBoolSpan(handle, values, first, count, debug) : 0;
+}
+
+inline s32 getS32Span(FlagHandle handle, s32* values, s32 first, s32 count, bool debug = false) {
+    auto* mgr = Manager::instance();
+    return mgr ? mgr->getS32Span(handle, values, first, count, debug) : 0;
+}
+
+inline s32 getStr64Span(FlagHandle handle, const char** values, s32 first, s32 count,
+                        bool debug = false) {
+    auto* mgr = Manager::instance();
+    return mgr ? mgr->getStr64Span(handle, values, first, count, debug) : 0;
+}
+
 #define GDT_SET_FLAG_(NAME, T)                                                                     \
     inline void NAME(T value, FlagHandle handle, bool debug = false) {                             \
         auto* mgr = Manager::instance();                                                           \
@@ -160,6 +178,26 @@ GDT_SET_FLAG_(setVec4f, const sead::Vector4f&)
 
 #undef GDT_SET_FLAG_
 
+/// Writes `count` elements of an array flag, starting at element `first`.
+/// @return the number of elements that were set.
+inline s32 setBoolSpan(const bool* values, FlagHandle handle, s32 first, s32 count,
+                       bool debug = false) {
+    auto* mgr = Manager::instance();
+    return mgr ? mgr->setBoolSpan(values, handle, first, count, debug) : 0;
+}
+
+inline s32 setS32Span(const s32* values, FlagHandle handle, s32 first, s32 count,
+                      bool debug = false) {
+    auto* mgr = Manager::instance();
+    return mgr ? mgr->setS32Span(values, handle, first, count, debug) : 0;
+}
+
+inline s32 setStr64Span(const char* const* values, FlagHandle handle, s32 first, s32 count,
+                        bool debug = false) {
+    auto* mgr = Manager::instance();
+    return mgr ? mgr->setStr64Span(values, handle, first, count, debug) : 0;
+}
+
 #define GDT_RESET_FLAG_(NAME)                                                                      \
     [[gnu::noinline]] inline void NAME(FlagHandle handle, bool debug = false) {                    \
         auto* mgr = Manager::instance();                                                           \
@@ -16,6 +16,7 @@
 #include "KingSystem/Resource/resLoadRequest.h"
 #include "KingSystem/Resource/resResourceGameData.h"
 #include "KingSystem/Resource/resSystem.h"
+#include "KingSystem/System/MemoryProfiler.h"
 #include "KingSystem/System/OverlayArenaSystem.h"
 #include "KingSystem/Utils/Byaml/Byaml.h"
 #include "KingSystem/Utils/Byaml/ByamlArrayIter.h"
@@ -84,6 +85,8 @@ void Manager::init(sead::Heap* heap, sead::Framework* framework) {
 
     mGameDataHeap = util::DualHeap::create(0xf00000, "GameDataHeap", heap, nullptr, sizeof(void*),
                                            sead::Heap::cHeapDirection_Forward, true);
+    if (auto* profiler = MemoryProfiler::instance())
+        profiler->trackHeap(mGameDataHeap, MemoryProfiler::HeapType::DualHeap);
     mIncreaseLogger = new (mGameDataHeap) IncreaseLogger;
     SaveMgr::createInstance(mGameDataHeap);
 
@@ -114,6 +117,7 @@ void Manager::init(sead::Heap* heap, sead::Framework* framework) {
     mSaveAreaHeap =
         util::DualHeap::create(0x500000, "SaveAreaHeap", mGameDataHeap, nullptr, sizeof(void*),
                                sead::Heap::cHeapDirection_Reverse, false);
+    trackSubHeap(mGameDataHeap, mSaveAreaHeap);
 
     SaveMgr::instance()->loadGameSaveData();
 
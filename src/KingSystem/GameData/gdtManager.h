@@ -146,6 +146,37 @@ public:
 
 #undef PROXY_GET_SET_IMPL_
 
+#define PROXY_GET_SET_SPAN_IMPL_(GET_NAME, SET_NAME, TYPE)                                         \
+    s32 GET_NAME(TYPE* values, s32 array_index, s32 first, s32 count) const {                      \
+        return getBuffer()->GET_NAME(values, array_index, first, count, mRef.mCheckPermissions);   \
+    }                                                                                              \
+                                                                                                   \
+    s32 SET_NAME(const TYPE* values, s32 array_idx, s32 first, s32 count,                          \
+                 bool bypass_one_trigger_check = false) {                                          \
+        if (mRef.mChangeOnlyOnce)                                                                  \
+            return 0;                                                                              \
+        const bool check = mRef.mCheckPermissions;                                                 \
+        const bool bypass = bypass_one_trigger_check;                                              \
+        s32 num_set = 0;                                                                           \
+        /* Like the single element setter, only propagate elements that were set in param1. */     \
+        /* Elements that cannot be set are skipped. */                                             \
+        for (s32 i = 0; i < count;) {                                                              \
+            const s32 n = getBuffer1()->SET_NAME(values + i, array_idx, first + i, count - i,      \
+                                                 check, bypass);                                   \
+            if (mRef.mPropagateParam1Changes && n != 0)                                            \
+                getBuffer0()->SET_NAME(values + i, array_idx, first + i, n, check, bypass);        \
+            num_set += n;                                                                          \
+            i += n + 1;                                                                            \
+        }                                                                                          \
+        return num_set;                                                                            \
+    }
+
+        PROXY_GET_SET_SPAN_IMPL_(getBoolSpan, setBoolSpan, bool)
+        PROXY_GET_SET_SPAN_IMPL_(getS32Span, setS32Span, s32)
+        PROXY_GET_SET_SPAN_IMPL_(getStr64Span, setStr64Span, char const*)
+
+#undef PROXY_GET_SET_SPAN_IMPL_
+
 #define PROXY_RESET_IMPL_(NAME)                                                                    \
     bool NAME(s32 idx) { return getBuffer1()->NAME(idx, mRef.mCheckPermissions); }                 \
     bool NAME(s32 idx, s32 sub_idx) {                                                              \
@@ -424,6 +455,35 @@ public:
 
 #undef GDT_SET_
 
+#define GDT_GET_SET_SPAN_(GET_NAME, SET_NAME, T)                                                   \
+    /* Getters and setters for array spans (by handle). The handle is only unwrapped once. */      \
+    s32 GET_NAME(FlagHandle handle, T* values, s32 first, s32 count, bool debug = false) {         \
+        s32 num_read = 0;                                                                          \
+        unwrapHandle<false>(handle, debug, [&](u32 idx, TriggerParamRef& ref) {                    \
+            num_read = ref.get().GET_NAME(values, idx, first, count);                              \
+            return num_read != 0;                                                                  \
+        });                                                                                        \
+        return num_read;                                                                           \
+    }                                                                                              \
+    s32 SET_NAME(const T* values, FlagHandle handle, s32 first, s32 count, bool debug = false) {   \
+        if (debug)                                                                                 \
+            onChangedByDebug();                                                                    \
+        if (mBitFlags.isOn(BitFlag::_40000))                                                       \
+            return 0;                                                                              \
+        s32 num_set = 0;                                                                           \
+        unwrapHandle<true>(handle, debug, [&](u32 idx, TriggerParamRef& ref) {                     \
+            num_set = ref.get().SET_NAME(values, idx, first, count, debug);                        \
+            return num_set != 0;                                                                   \
+        });                                                                                        \
+        return num_set;                                                                            \
+    }
+
+    GDT_GET_SET_SPAN_(getBoolSpan, setBoolSpan, bool)
+    GDT_GET_SET_SPAN_(getS32Span, setS32Span, s32)
+    GDT_GET_SET_SPAN_(getStr64Span, setStr64Span, char const*)
+
+#undef GDT_GET_SET_SPAN_
+
 #define GDT_RESET_(NAME)                                                                           \
     bool NAME(const sead::SafeString& name);                                                       \
     bool NAME##_(const sead::SafeString& name);                                                    \
@@ -170,6 +170,35 @@ inline bool getFlagValue(const sead::PtrArray<sead::PtrArray<FlagBase>>& arrays,
     return true;
 }
 
+template <typename T, typename FlagValueType = T>
+inline s32 getFlagValues(const sead::PtrArray<sead::PtrArray<FlagBase>>& arrays, T* out_values,
+                         s32 array_index, s32 first, s32 count, bool check_permissions) {
+    static_assert(isValidFlagValueType<FlagValueType>());
+
+    if (array_index < 0 || array_index >= arrays.size())
+        return 0;
+
+    const auto* array = arrays[array_index];
+    if (!array)
+        return 0;
+
+    for (s32 i = 0; i < count; ++i) {
+        const auto* flag = getFlagByIndex<FlagValueType>(*array, first + i);
+        if (!flag)
+            return i;
+
+        if (check_permissions && !flag->isProgramReadable())
+            return i;
+
+        if constexpr (std::is_same<T, const char*>())
+            out_values[i] = flag->getValueRef().cstr();
+        else
+            out_values[i] = flag->getValue();
+    }
+
+    return count;
+}
+
 /// Modifies the value of a flag.
 /// @param success A non-null pointer to a boolean that is set to true if an attempt was made to
 ///                change the value.
@@ -1172,6 +1201,22 @@ bool TriggerParam::getVec4f(sead::Vector4f* value, s32 array_index, s32 index,
     return getFlagValue(mVector4fArrayFlags, value, array_index, index, check_permissions);
 }
 
+s32 TriggerParam::getBoolSpan(bool* values, s32 array_index, s32 first, s32 count,
+                              bool check_permissions) const {
+    return getFlagValues(mBoolArrayFlags, values, array_index, first, count, check_permissions);
+}
+
+s32 TriggerParam::getS32Span(s32* values, s32 array_index, s32 first, s32 count,
+                             bool check_permissions) const {
+    return getFlagValues(mS32ArrayFlags, values, array_index, first, count, check_permissions);
+}
+
+s32 TriggerParam::getStr64Span(const char** values, s32 array_index, s32 first, s32 count,
+                               bool check_permissions) const {
+    return getFlagValues<const char*, sead::FixedSafeString<64>>(
+        mString64ArrayFlags, values, array_index, first, count, check_permissions);
+}
+
 bool TriggerParam::getBool(bool* value, const sead::SafeString& name, s32 index,
                            bool check_permissions, bool x) const {
     return getBool(value, getBoolArrayIdx(name), index, check_permissions);
@@ -1401,6 +1446,34 @@ bool TriggerParam::getMaxValueForS32(s32* max, const sead::SafeString& name) con
                              bypass_one_trigger_check);                                            \
     }
 
+#define SET_ARRAY_FLAG_SPAN_IMPL_(FUNCTION_NAME, ARG_VALUE_TYPE, FLAGS, T)                         \
+    s32 FUNCTION_NAME(const ARG_VALUE_TYPE* values, s32 idx, s32 first, s32 count,                 \
+                      bool check_permissions, bool bypass_one_trigger_check) {                     \
+        if (idx < 0 || idx >= FLAGS.size())                                                        \
+            return 0;                                                                              \
+                                                                                                   \
+        const auto* array = FLAGS[idx];                                                            \
+        if (!array)                                                                                \
+            return 0;                                                                              \
+                                                                                                   \
+        for (s32 i = 0; i < count; ++i) {                                                          \
+            const s32 sub_idx = first + i;                                                         \
+            const T value{values[i]};                                                              \
+            bool success = false;                                                                  \
+            if (!doSetFlagValue<T>(&success, value, *array, sub_idx, check_permissions,            \
+                                   bypass_one_trigger_check)) {                                    \
+                return i;                                                                          \
+            }                                                                                      \
+                                                                                                   \
+            if (success) {                                                                         \
+                const auto* flag = (*array)[sub_idx];                                              \
+                recordFlagChange(flag, idx, sub_idx);                                              \
+                reportFlagChange<T>(flag, sub_idx);                                                \
+            }                                                                                      \
+        }                                                                                          \
+        return count;                                                                              \
+    }
+
 SET_FLAG_VALUE_IMPL_(TriggerParam::setBool, bool, mBoolFlags, bool, value)
 
 void TriggerParam::recordFlagChange(const FlagBase* flag, s32 idx, s32 sub_idx) {
@@ -1473,6 +1546,11 @@ SET_ARRAY_FLAG_VALUE_BY_KEY_IMPL_(TriggerParam::setVec2f, getVec2fArrayIdx, cons
 SET_ARRAY_FLAG_VALUE_BY_KEY_IMPL_(TriggerParam::setVec3f, getVec3fArrayIdx, const sead::Vector3f&)
 SET_ARRAY_FLAG_VALUE_BY_KEY_IMPL_(TriggerParam::setVec4f, getVec4fArrayIdx, const sead::Vector4f&)
 
+SET_ARRAY_FLAG_SPAN_IMPL_(TriggerParam::setBoolSpan, bool, mBoolArrayFlags, bool)
+SET_ARRAY_FLAG_SPAN_IMPL_(TriggerParam::setS32Span, s32, mS32ArrayFlags, s32)
+SET_ARRAY_FLAG_SPAN_IMPL_(TriggerParam::setStr64Span, char* const, mString64ArrayFlags,
+                          sead::FixedSafeString<64>)
+
 #define RESET_FLAG_VALUE_IMPL_(FUNCTION_NAME, FLAGS, T)                                            \
     bool FUNCTION_NAME(s32 idx, bool check_permissions) {                                          \
         bool was_reset = false;                                                                    \
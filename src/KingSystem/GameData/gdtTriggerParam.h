@@ -99,6 +99,20 @@ public:
 
     // endregion
 
+    // region Value getters (array spans)
+
+    /// Reads `count` consecutive elements of an array flag, starting at element `first`.
+    /// @return the number of elements that were read. Reading stops at the first element that
+    ///         does not exist or is not readable.
+    s32 getBoolSpan(bool* values, s32 array_index, s32 first, s32 count,
+                    bool check_permissions) const;
+    s32 getS32Span(s32* values, s32 array_index, s32 first, s32 count,
+                   bool check_permissions) const;
+    s32 getStr64Span(const char** values, s32 array_index, s32 first, s32 count,
+                     bool check_permissions) const;
+
+    // endregion
+
     // region Value getters (by name)
 
     bool getBool(bool* value, const sead::SafeString& name, bool check_permissions,
@@ -336,6 +350,21 @@ public:
 
     // endregion
 
+    // region Value setters (array spans)
+
+    /// Writes `count` consecutive elements of an array flag, starting at element `first`.
+    /// Changes are recorded and reported exactly as if every element had been set individually.
+    /// @return the number of elements that were set. Writing stops at the first element that
+    ///         cannot be set to the specified value.
+    s32 setBoolSpan(const bool* values, s32 idx, s32 first, s32 count, bool check_permissions,
+                    bool bypass_one_trigger_check);
+    s32 setS32Span(const s32* values, s32 idx, s32 first, s32 count, bool check_permissions,
+                   bool bypass_one_trigger_check);
+    s32 setStr64Span(const char* const* values, s32 idx, s32 first, s32 count,
+                     bool check_permissions, bool bypass_one_trigger_check);
+
+    // endregion
+
     // region Resetting values
 
     bool resetBool(s32 idx, bool check_permissions);
@@ -1,5 +1,7 @@
 
 #include "KingSystem/Quest/qstManager.h"
+#include <codec/seadHashCRC32.h>
+#include "KingSystem/ActorSystem/actActor.h"
 #include "KingSystem/Quest/qstActorData.h"
 #include "KingSystem/Utils/HeapUtil.h"
 #include "KingSystem/Utils/SafeDelete.h"
@@ -29,6 +31,7 @@ void Manager::init(sead::Heap* heap) {
 }
 
 void Manager::cleanUp() {
+    mIndex.clear();
     _44 = 0;
     _48.freeBuffer();
     mQuests.freeBuffer();
@@ -36,6 +39,9 @@ void Manager::cleanUp() {
 }
 
 bool Manager::isQuestActor(act::Actor* actor) const {
+    if (!mIndex.mayBeQuestActor(sead::HashCRC32::calcStringHash(actor->getName())))
+        return false;
+
     for (int i = 0; i < mQuests.size(); ++i) {
         const auto* quest = mQuests[i];
         if (quest->x_6(actor))
@@ -78,7 +84,7 @@ bool Manager::sub_7100FD78F8() {
     }
 
     if (data_count == 0)
-        return true;
+        return buildIndex();
     if (!_48.tryAllocBuffer(data_count, mHeap, 8))
         return false;
 
@@ -91,10 +97,52 @@ bool Manager::sub_7100FD78F8() {
             }
         }
     }
-    return true;
+    return buildIndex();
 }
 #endif
 
+bool Manager::buildIndex() {
+    return mIndex.build(mQuests, mHeap);
+}
+
+const Step* Manager::getStep(const sead::SafeString& quest_name,
+                             const sead::SafeString& step_name) const {
+    const u32 hash = sead::HashCRC32::calcStringHash(quest_name.cstr());
+    const Step* step = nullptr;
+
+    if (!mIndex.isBuilt()) {
+        for (const auto& quest : mQuests) {
+            if (quest.mNameHash != hash)
+                continue;
+            for (const auto& s : quest.mSteps) {
+                if (step_name == s.name)
+                    return &s;
+            }
+        }
+        return nullptr;
+    }
+
+    mIndex.forEachQuest(hash, [&](s32 quest_idx) {
+        const s32 step_idx = mIndex.findStep(quest_idx, step_name);
+        if (step_idx < 0)
+            return false;
+        step = mQuests[quest_idx]->mSteps[step_idx];
+        return true;
+    });
+    return step;
+}
+
+s32 Manager::filterSpawnedActors(act::Actor* const* actors, s32 num_actors,
+                                 act::Actor** out_actors) const {
+    s32 num_out = 0;
+    for (s32 i = 0; i < num_actors; ++i) {
+        const u32 hash = sead::HashCRC32::calcStringHash(actors[i]->getName());
+        if (mIndex.isQuestActorName(hash))
+            out_actors[num_out++] = actors[i];
+    }
+    return num_out;
+}
+
 bool Manager::sub_7100FD7B30(const sead::SafeString& quest_name, const sead::SafeString& step_name,
                              bool setAocVersionFlag1) {
     return setQuestStep(quest_name, step_name, false, false, setAocVersionFlag1);
@@ -111,11 +159,21 @@ bool Manager::setQuestStepFromEvent(const sead::SafeString& quest_name,
 bool Manager::setQuestStep(const sead::SafeString& quest_name, const sead::SafeString& step_name,
                            bool copy_name, bool force_run_telop, bool setAocVersionFlag1) {
     u32 hash = sead::HashCRC32::calcStringHash(quest_name.cstr());
-    Quest* quest;
-    for (auto& q : mQuests) {
+    Quest* quest = nullptr;
+    const auto is_candidate = [&](Quest& q) {
         if (q._c - 1 <= 1 && q.mNameHash == hash) {
             quest = &q;
-            break;
+            return true;
+        }
+        return false;
+    };
+
+    if (mIndex.isBuilt()) {
+        mIndex.forEachQuest(hash, [&](s32 idx) { return is_candidate(*mQuests[idx]); });
+    } else {
+        for (auto& q : mQuests) {
+            if (is_candidate(q))
+                break;
         }
     }
     if (quest == nullptr)
@@ -4,6 +4,7 @@
 #include <heap/seadDisposer.h>
 #include <prim/seadSafeString.h>
 #include "KingSystem/Quest/qstQuest.h"
+#include "KingSystem/Quest/qstQuestIndex.h"
 #include "KingSystem/Resource/resHandle.h"
 #include "agl/Utils/aglParameter.h"
 
@@ -34,6 +35,22 @@ public:
                       bool copy_name, bool force_run_telop, bool setAocVersionFlag1);
 
     bool isQuestActor(act::Actor* actor) const;
+
+    /// Rebuilds the quest, step and actor lookup tables. Must be called after quests are loaded.
+    bool buildIndex();
+    const QuestIndex& getIndex() const { return mIndex; }
+
+    /// @return the step with the specified name in the specified quest, or nullptr.
+    const Step* getStep(const sead::SafeString& quest_name,
+                        const sead::SafeString& step_name) const;
+
+    /// Checks a batch of newly spawned actors and writes the ones that quests may refer to
+    /// to `out_actors` (which must be at least as large as `actors`). Most actors are rejected
+    /// by the actor name Bloom filter without looking at any quest.
+    /// @return the number of actors that were written.
+    s32 filterSpawnedActors(act::Actor* const* actors, s32 num_actors,
+                            act::Actor** out_actors) const;
+
     static act::BaseProc* sub_7100FD5848(const sead::SafeString& s1, const sead::SafeString& s2);
 
 private:
@@ -54,6 +71,7 @@ private:
     u32 _e4;
     s32 _e8 = -1;
     u32 _d0 = 0;
+    QuestIndex mIndex;
 
     static bool sDisable;
 };
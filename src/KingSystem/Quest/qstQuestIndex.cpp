@@ -0,0 +1,141 @@
+#include "KingSystem/Quest/qstQuestIndex.h"
+#include <algorithm>
+#include <codec/seadHashCRC32.h>
+#include "KingSystem/Quest/qstQuest.h"
+#include "KingSystem/Quest/qstStep.h"
+
+namespace ksys::qst {
+
+bool QuestIndex::build(const sead::ObjArray<Quest>& quests, sead::Heap* heap) {
+    clear();
+
+    s32 num_steps = 0;
+    s32 num_actors = 0;
+    for (const auto& quest : quests) {
+        num_steps += quest.mSteps.size();
+        for (const auto& step : quest.mSteps)
+            num_actors += step.links.size();
+    }
+
+    if (quests.size() != 0 && !mQuests.tryAllocBuffer(quests.size(), heap))
+        return false;
+    if (num_steps != 0 && !mSteps.tryAllocBuffer(num_steps, heap))
+        return false;
+    if (num_actors != 0 && !mActorNames.tryAllocBuffer(num_actors, heap))
+        return false;
+
+    s32 step_entry_idx = 0;
+    for (s32 quest_idx = 0; quest_idx < quests.size(); ++quest_idx) {
+        const auto* quest = quests[quest_idx];
+        mQuests[quest_idx] = {quest->mNameHash, quest_idx};
+
+        for (s32 step_idx = 0; step_idx < quest->mSteps.size(); ++step_idx) {
+            const auto* step = quest->mSteps[step_idx];
+            const u32 step_hash = sead::HashCRC32::calcStringHash(step->name);
+            mSteps[step_entry_idx++] = {quest_idx, step_hash, step_idx};
+
+            for (const auto& link : step->links) {
+                if (!link.name || sead::SafeString(link.name).isEmpty()) {
+                    mFilterDisabled = true;
+                    continue;
+                }
+                const u32 actor_hash = sead::HashCRC32::calcStringHash(link.name);
+                mActorNames[mNumActorNames++] = actor_hash;
+                addToFilter(actor_hash);
+            }
+        }
+    }
+
+    // Sort by hash, then by index so that lookups return quests and steps in array order.
+    std::sort(mQuests.getBufferPtr(), mQuests.getBufferPtr() + mQuests.size(),
+              [](const QuestEntry& lhs, const QuestEntry& rhs) {
+                  if (lhs.name_hash != rhs.name_hash)
+                      return lhs.name_hash < rhs.name_hash;
+                  return lhs.quest_idx < rhs.quest_idx;
+              });
+
+    std::sort(mSteps.getBufferPtr(), mSteps.getBufferPtr() + mSteps.size(),
+              [](const StepEntry& lhs, const StepEntry& rhs) {
+                  if (lhs.quest_idx != rhs.quest_idx)
+                      return lhs.quest_idx < rhs.quest_idx;
+                  if (lhs.name_hash != rhs.name_hash)
+                      return lhs.name_hash < rhs.name_hash;
+                  return lhs.step_idx < rhs.step_idx;
+              });
+
+    u32* names = mActorNames.getBufferPtr();
+    std::sort(names, names + mNumActorNames);
+    mNumActorNames = s32(std::unique(names, names + mNumActorNames) - names);
+
+    mIsBuilt = true;
+    return true;
+}
+
+void QuestIndex::clear() {
+    mIsBuilt = false;
+    mFilterDisabled = false;
+    mQuests.freeBuffer();
+    mSteps.freeBuffer();
+    mActorNames.freeBuffer();
+    mNumActorNames = 0;
+    for (auto& word : mFilter)
+        word = 0;
+}
+
+s32 QuestIndex::findStep(s32 quest_idx, const sead::SafeString& step_name) const {
+    if (!mIsBuilt)
+        return -1;
+
+    const u32 name_hash = sead::HashCRC32::calcStringHash(step_name);
+    const auto* begin = mSteps.getBufferPtr();
+    const auto* end = begin + mSteps.size();
+    const auto* it = std::lower_bound(begin, end, StepEntry{quest_idx, name_hash, 0},
+                                      [](const StepEntry& lhs, const StepEntry& rhs) {
+                                          if (lhs.quest_idx != rhs.quest_idx)
+                                              return lhs.quest_idx < rhs.quest_idx;
+                                          return lhs.name_hash < rhs.name_hash;
+                                      });
+
+    if (it == end || it->quest_idx != quest_idx || it->name_hash != name_hash)
+        return -1;
+    return it->step_idx;
+}
+
+u32 QuestIndex::getFilterBit(u32 hash, s32 i) {
+    constexpr u32 Shift = 17;
+    static_assert(NumFilterBits == 1 << (32 - Shift));
+    // Derive the filter hashes from the CRC32 with different odd multipliers.
+    constexpr u32 Multipliers[NumFilterHashes] = {0x9e3779b1, 0x85ebca77, 0xc2b2ae3d};
+    return (hash * Multipliers[i]) >> Shift;
+}
+
+void QuestIndex::addToFilter(u32 actor_name_hash) {
+    for (s32 i = 0; i < NumFilterHashes; ++i) {
+        const u32 bit = getFilterBit(actor_name_hash, i);
+        mFilter[bit / 32] |= 1u << (bit % 32);
+    }
+}
+
+bool QuestIndex::mayBeQuestActor(u32 actor_name_hash) const {
+    if (!mIsBuilt || mFilterDisabled)
+        return true;
+
+    for (s32 i = 0; i < NumFilterHashes; ++i) {
+        const u32 bit = getFilterBit(actor_name_hash, i);
+        if (!(mFilter[bit / 32] & (1u << (bit % 32))))
+            return false;
+    }
+    return true;
+}
+
+bool QuestIndex::isQuestActorName(u32 actor_name_hash) const {
+    if (!mayBeQuestActor(actor_name_hash))
+        return false;
+    if (!mIsBuilt || mFilterDisabled)
+        return true;
+
+    const u32* names = mActorNames.getBufferPtr();
+    return std::binary_search(names, names + mNumActorNames, actor_name_hash);
+}
+
+}  // namespace ksys::qst
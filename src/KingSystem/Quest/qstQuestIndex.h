@@ -0,0 +1,102 @@
+#pragma once
+
+#include <basis/seadTypes.h>
+#include <container/seadBuffer.h>
+#include <container/seadObjArray.h>
+#include <prim/seadSafeString.h>
+
+namespace sead {
+class Heap;
+}
+
+namespace ksys::qst {
+
+struct Quest;
+
+/// Lookup tables for the loaded quests, so that quests, steps and quest actors can be found
+/// without scanning every quest and comparing names.
+///
+/// All tables are sorted arrays of hashes that are searched with a binary search.
+/// A Bloom filter over actor names lets most spawned actors be rejected with a few bit tests.
+/// The index only depends on the quest data (names, steps and step actors). It must be rebuilt
+/// whenever quests are loaded and cleared when they are unloaded.
+class QuestIndex {
+public:
+    static constexpr s32 NumFilterBits = 0x8000;
+    static constexpr s32 NumFilterHashes = 3;
+
+    QuestIndex() = default;
+    ~QuestIndex() { clear(); }
+    QuestIndex(const QuestIndex&) = delete;
+    auto operator=(const QuestIndex&) = delete;
+
+    bool build(const sead::ObjArray<Quest>& quests, sead::Heap* heap);
+    void clear();
+    bool isBuilt() const { return mIsBuilt; }
+
+    /// Calls `fn(quest_idx)` for every quest with the specified name hash, in array order,
+    /// until `fn` returns true.
+    /// @return whether `fn` returned true.
+    template <typename Function>
+    bool forEachQuest(u32 name_hash, const Function& fn) const;
+
+    /// @return the index of the step in the specified quest, or -1 if there is no such step.
+    s32 findStep(s32 quest_idx, const sead::SafeString& step_name) const;
+
+    /// Only checks the Bloom filter: may return true for actors that are not quest actors.
+    /// Returns true if the index has not been built.
+    bool mayBeQuestActor(u32 actor_name_hash) const;
+    /// @return whether a step of any quest refers to an actor with this name.
+    ///         Returns true if the index has not been built.
+    bool isQuestActorName(u32 actor_name_hash) const;
+
+private:
+    struct QuestEntry {
+        u32 name_hash;
+        s32 quest_idx;
+    };
+
+    struct StepEntry {
+        s32 quest_idx;
+        u32 name_hash;
+        s32 step_idx;
+    };
+
+    static u32 getFilterBit(u32 hash, s32 i);
+    void addToFilter(u32 actor_name_hash);
+
+    bool mIsBuilt = false;
+    /// Set if a step actor has no name, in which case actors cannot be filtered by name.
+    bool mFilterDisabled = false;
+    sead::Buffer<QuestEntry> mQuests;
+    sead::Buffer<StepEntry> mSteps;
+    /// Sorted and unique.
+    sead::Buffer<u32> mActorNames;
+    s32 mNumActorNames = 0;
+    u32 mFilter[NumFilterBits / 32]{};
+};
+
+template <typename Function>
+inline bool QuestIndex::forEachQuest(u32 name_hash, const Function& fn) const {
+    if (!mIsBuilt)
+        return false;
+
+    // Find the first entry with this hash. Entries with the same hash are sorted by index.
+    s32 a = 0;
+    s32 b = mQuests.size();
+    while (a < b) {
+        const s32 m = (a + b) / 2;
+        if (mQuests[m].name_hash < name_hash)
+            a = m + 1;
+        else
+            b = m;
+    }
+
+    for (s32 i = a; i < mQuests.size() && mQuests[i].name_hash == name_hash; ++i) {
+        if (fn(mQuests[i].quest_idx))
+            return true;
+    }
+    return false;
+}
+
+}  // namespace ksys::qst
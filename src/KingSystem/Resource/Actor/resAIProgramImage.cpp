@@ -0,0 +1,148 @@
+#include "KingSystem/Resource/Actor/resAIProgramImage.h"
+#include <codec/seadHashCRC32.h>
+#include <cstring>
+#include <heap/seadExpHeap.h>
+
+namespace ksys::res {
+
+SEAD_SINGLETON_DISPOSER_IMPL(AIProgramImageCache)
+
+u32 AIProgramImage::calcSize(u32 num_defs, u32 num_params, u32 num_u16, u32 num_u8,
+                             u32 strings_size) {
+    u32 size = sizeof(Header);
+    size += sizeof(Def) * num_defs;
+    size += sizeof(Param) * num_params;
+    size += sizeof(u16) * num_u16;
+    size += sizeof(u8) * num_u8;
+    size += strings_size;
+    return size;
+}
+
+u32 AIProgramImage::calcSourceHash(const u8* data, u32 size) {
+    return sead::HashCRC32::calcHash(data, size);
+}
+
+AIProgramImageCache::AIProgramImageCache() = default;
+
+// The images are freed along with the heap, which is a child of the heap the cache lives in.
+AIProgramImageCache::~AIProgramImageCache() = default;
+
+bool AIProgramImageCache::init(sead::Heap* heap, u32 max_size) {
+    // Images are added from resource loading threads, so the heap needs a lock.
+    // Leave some room for the block headers of every image.
+    mHeap = sead::ExpHeap::create(max_size + MaxImages * 0x40, "AIProgramImageCache", heap,
+                                  sizeof(void*), sead::Heap::cHeapDirection_Forward, true);
+    if (!mHeap)
+        return false;
+    mMaxSize = max_size;
+    return true;
+}
+
+AIProgramImageCache::Entry* AIProgramImageCache::findEntry(u32 source_hash, u32 source_size) {
+    for (s32 i = 0; i < mNumEntries; ++i) {
+        auto& entry = mEntries[i];
+        if (entry.source_hash == source_hash && entry.source_size == source_size &&
+            !entry.rejected) {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+const u8* AIProgramImageCache::acquireImage(u32 source_hash, u32 source_size, u32* image_size) {
+    const auto lock = sead::makeScopedLock(mCritSection);
+
+    Entry* entry = findEntry(source_hash, source_size);
+    if (!entry) {
+        ++mStats.num_misses;
+        return nullptr;
+    }
+
+    ++mStats.num_hits;
+    ++entry->num_users;
+    entry->last_use = ++mUseCounter;
+    *image_size = entry->image_size;
+    return entry->image;
+}
+
+void AIProgramImageCache::releaseImage(const u8* image) {
+    const auto lock = sead::makeScopedLock(mCritSection);
+
+    for (s32 i = 0; i < mNumEntries; ++i) {
+        auto& entry = mEntries[i];
+        if (entry.image != image)
+            continue;
+
+        --entry.num_users;
+        if (entry.rejected && entry.num_users == 0)
+            evictEntry(i);
+        return;
+    }
+}
+
+void AIProgramImageCache::evictEntry(s32 idx) {
+    mTotalSize -= mEntries[idx].image_size;
+    delete[] mEntries[idx].image;
+    mEntries[idx] = mEntries[--mNumEntries];
+    mEntries[mNumEntries] = {};
+}
+
+u8* AIProgramImageCache::allocImage(const AIProgramImage::Header& header) {
+    if (!mHeap || header.image_size > mMaxSize)
+        return nullptr;
+
+    if (findEntry(header.source_hash, header.source_size))
+        return nullptr;
+
+    // Evict the least recently used images until the new one fits.
+    while (mNumEntries == MaxImages || mTotalSize + header.image_size > mMaxSize) {
+        s32 lru_idx = -1;
+        for (s32 i = 0; i < mNumEntries; ++i) {
+            if (mEntries[i].num_users != 0)
+                continue;
+            if (lru_idx < 0 || mEntries[i].last_use < mEntries[lru_idx].last_use)
+                lru_idx = i;
+        }
+        // Every remaining image is in use.
+        if (lru_idx < 0)
+            return nullptr;
+        evictEntry(lru_idx);
+        ++mStats.num_evicted;
+    }
+
+    auto* image = new (mHeap, 8, std::nothrow_t()) u8[header.image_size];
+    if (!image)
+        return nullptr;
+
+    auto& entry = mEntries[mNumEntries++];
+    entry.image = image;
+    entry.source_hash = header.source_hash;
+    entry.source_size = header.source_size;
+    entry.image_size = header.image_size;
+    entry.last_use = ++mUseCounter;
+    entry.num_users = 0;
+    entry.rejected = false;
+    mTotalSize += header.image_size;
+    return image;
+}
+
+void AIProgramImageCache::rejectImage(u32 source_hash, u32 source_size) {
+    const auto lock = sead::makeScopedLock(mCritSection);
+
+    for (s32 i = 0; i < mNumEntries; ++i) {
+        auto& entry = mEntries[i];
+        if (entry.source_hash != source_hash || entry.source_size != source_size ||
+            entry.rejected) {
+            continue;
+        }
+
+        ++mStats.num_rejected;
+        if (entry.num_users == 0)
+            evictEntry(i);
+        else
+            entry.rejected = true;
+        return;
+    }
+}
+
+}  // namespace ksys::res
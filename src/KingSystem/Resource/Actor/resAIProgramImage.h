@@ -0,0 +1,201 @@
+#pragma once
+
+#include <basis/seadTypes.h>
+#include <container/seadSafeArray.h>
+#include <heap/seadDisposer.h>
+#include <prim/seadScopedLock.h>
+#include <thread/seadCriticalSection.h>
+#include "KingSystem/Utils/Types.h"
+
+namespace sead {
+class ExpHeap;
+}
+
+namespace ksys::res {
+
+/// Serialised form of a parsed AIProgram.
+///
+/// An image is a single block that only contains offsets, so it can be copied around freely:
+/// strings from the source archive (class names, string parameters) are stored as offsets into
+/// the archive, and parameter names as offsets into the image's own string pool. Loading an
+/// image only requires copying the index arrays and fixing up pointers, instead of walking the
+/// archive and resolving every class definition again.
+struct AIProgramImage {
+    static constexpr u32 Magic = 0x49504941;  // "AIPI"
+    static constexpr u32 Version = 1;
+    /// Marks a string offset that does not point into the source archive (empty string).
+    static constexpr u32 NullOffset = 0xffffffff;
+
+    enum class Kind : u8 {
+        AI = 0,
+        Action = 1,
+        Behavior = 2,
+        Query = 3,
+    };
+    static constexpr s32 NumKinds = 4;
+
+    enum class ParamType : u8 {
+        String = 0,
+        UInt = 1,
+        Int = 2,
+        Float = 3,
+        Vec3 = 4,
+        Bool = 5,
+    };
+
+    struct Def {
+        u32 class_name;
+        u32 name;
+        u32 group_name;
+        /// Index of the first Param record.
+        u32 first_param;
+        /// Size of the static parameter array (including null entries).
+        u16 num_sinst_params;
+        /// Number of Param records.
+        u16 num_params;
+        /// Index into the u16 pool.
+        u32 first_child;
+        /// Index into the u8 pool.
+        u32 first_behavior;
+        u16 num_children;
+        u16 num_behaviors;
+        u16 param1;
+        u16 param2;
+    };
+    KSYS_CHECK_SIZE_NX150(Def, 0x24);
+
+    struct Param {
+        u16 idx;
+        ParamType type;
+        u8 reserved;
+        /// Offset into the string pool.
+        u32 name;
+        /// Raw value, or for strings, the offset of the value in the source archive.
+        u32 value[3];
+    };
+    KSYS_CHECK_SIZE_NX150(Param, 0x14);
+
+    struct Header {
+        u32 magic;
+        u32 version;
+        u32 source_hash;
+        u32 source_size;
+        u32 image_size;
+        u32 num_defs[NumKinds];
+        u32 num_params;
+        u32 num_u16;
+        u32 num_u8;
+        u32 strings_size;
+        u32 num_demo_ai_action_indices;
+        u32 num_demo_behavior_indices;
+        u32 reserved;
+    };
+    KSYS_CHECK_SIZE_NX150(Header, 0x40);
+
+    // The header is followed by, in order: Def records (for each kind), Param records,
+    // the u16 pool (child indices, then demo AI/action indices), the u8 pool (behavior
+    // indices, then demo behavior indices) and the string pool.
+
+    static u32 calcSize(u32 num_defs, u32 num_params, u32 num_u16, u32 num_u8, u32 strings_size);
+
+    /// Computes the key of a source archive: a CRC32 of the whole archive. Images contain
+    /// parameter values, so every byte of the archive affects their contents.
+    static u32 calcSourceHash(const u8* data, u32 size);
+};
+
+/// Keeps AIProgram images in memory so that programs that are reloaded (e.g. on every area
+/// transition) do not need to be parsed again. Images are keyed by the size and CRC32
+/// (see AIProgramImage::calcSourceHash) of the source archive; the least recently used images
+/// are evicted when the cache is full.
+class AIProgramImageCache {
+    SEAD_SINGLETON_DISPOSER(AIProgramImageCache)
+    AIProgramImageCache();
+    virtual ~AIProgramImageCache();
+
+public:
+    static constexpr s32 MaxImages = 0x200;
+
+    struct Stats {
+        u32 num_hits;
+        u32 num_misses;
+        /// Number of images that were found but failed validation.
+        u32 num_rejected;
+        u32 num_evicted;
+    };
+
+    /// Creates the heap for the images.
+    /// @param max_size Maximum total size of all images.
+    bool init(sead::Heap* heap, u32 max_size);
+
+    /// Calls `fn(image, image_size)` with the image for the specified source archive.
+    /// The image is pinned so that it cannot be evicted, but the cache is not locked while
+    /// `fn` runs.
+    /// @return whether an image was found.
+    template <typename Function>
+    bool withImage(u32 source_hash, u32 source_size, const Function& fn);
+
+    /// Allocates an image of `header.image_size` bytes in the cache and calls `write(image)`
+    /// to fill it. `write` must also copy the header.
+    template <typename Function>
+    bool addImage(const AIProgramImage::Header& header, const Function& write);
+
+    /// Removes an image that failed validation.
+    void rejectImage(u32 source_hash, u32 source_size);
+
+    const Stats& getStats() const { return mStats; }
+
+private:
+    struct Entry {
+        u8* image;
+        u32 source_hash;
+        u32 source_size;
+        u32 image_size;
+        u32 last_use;
+        /// Number of withImage calls that are using the image. Pinned images are never evicted.
+        u16 num_users;
+        /// Set if the image was rejected while it was pinned; it is evicted once it is released.
+        bool rejected;
+    };
+
+    Entry* findEntry(u32 source_hash, u32 source_size);
+    const u8* acquireImage(u32 source_hash, u32 source_size, u32* image_size);
+    void releaseImage(const u8* image);
+    u8* allocImage(const AIProgramImage::Header& header);
+    void evictEntry(s32 idx);
+
+    sead::ExpHeap* mHeap = nullptr;
+    sead::CriticalSection mCritSection;
+    sead::SafeArray<Entry, MaxImages> mEntries{};
+    s32 mNumEntries = 0;
+    u32 mMaxSize = 0;
+    u32 mTotalSize = 0;
+    u32 mUseCounter = 0;
+    Stats mStats{};
+};
+
+template <typename Function>
+inline bool AIProgramImageCache::withImage(u32 source_hash, u32 source_size, const Function& fn) {
+    u32 image_size = 0;
+    const u8* image = acquireImage(source_hash, source_size, &image_size);
+    if (!image)
+        return false;
+
+    fn(image, image_size);
+    releaseImage(image);
+    return true;
+}
+
+template <typename Function>
+inline bool AIProgramImageCache::addImage(const AIProgramImage::Header& header,
+                                          const Function& write) {
+    const auto lock = sead::makeScopedLock(mCritSection);
+
+    u8* image = allocImage(header);
+    if (!image)
+        return false;
+
+    write(image);
+    return true;
+}
+
+}  // namespace ksys::res
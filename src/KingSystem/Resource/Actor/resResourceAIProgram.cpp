@@ -1,8 +1,13 @@
 #include "KingSystem/Resource/Actor/resResourceAIProgram.h"
 #include <agl/Utils/aglParameter.h>
+#include <codec/seadHashCRC32.h>
+#include <cstring>
 #include <heap/seadHeapMgr.h>
+#include <type_traits>
 #include "KingSystem/ActorSystem/actAiActionBase.h"
 #include "KingSystem/ActorSystem/actAiClassDef.h"
+#include "KingSystem/ActorSystem/actAiParam.h"
+#include "KingSystem/Resource/Actor/resAIProgramImage.h"
 #include "KingSystem/Resource/resCurrentResNameMgr.h"
 #include "KingSystem/Utils/HeapUtil.h"
 
@@ -68,9 +73,512 @@ static bool parseBehaviorIdx(agl::utl::ResParameterObj obj, sead::Buffer<u8>& bu
     return true;
 }
 
+namespace {
+
+using Image = AIProgramImage;
+
+bool isImageParamType(AIDefParamType type) {
+    switch (type) {
+    case AIDefParamType::String:
+    case AIDefParamType::Tree:
+    case AIDefParamType::UInt:
+    case AIDefParamType::Int:
+    case AIDefParamType::Float:
+    case AIDefParamType::Vec3:
+    case AIDefParamType::Bool:
+        return true;
+    default:
+        return false;
+    }
+}
+
+/// Static parameter slot of a definition, as found by ImageLayout.
+struct ImageParamSlot {
+    /// Null if the slot is not stored in the image.
+    const char* name;
+    AIDefParamType type;
+};
+
+/// Computes the size of each section of the image for a program that has just been parsed.
+/// Parameter names are not kept by agl, so they need to be looked up again; the results are
+/// kept in `slots` so that ImageWriter does not have to repeat the lookups.
+struct ImageLayout {
+    template <typename T>
+    void addDefs(const sead::Buffer<T>& defs, AIDefType type) {
+        for (const auto& def : defs) {
+            ++num_defs;
+            if constexpr (std::is_same<T, AIProgram::AIActionDef>()) {
+                num_u16 += u32(def.mChildIndices.size());
+                num_u8 += u32(def.mBehaviorIndices.size());
+            }
+
+            if (def.mSInstParams.size() == 0)
+                continue;
+
+            AIDef aidef;
+            AIClassDef::instance()->getDef(&aidef, def.mClassName, AIDefInstParamKind::Static,
+                                           type);
+            for (s32 i = 0; i < def.mSInstParams.size(); ++i) {
+                auto& slot = slots[num_slots++];
+                slot.name = nullptr;
+                if (i >= aidef.num_params || !def.mSInstParams[i] ||
+                    !isImageParamType(aidef.param_types[i])) {
+                    continue;
+                }
+                slot.name = aidef.param_names[i];
+                slot.type = aidef.param_types[i];
+                ++num_params;
+                strings_size += u32(std::strlen(slot.name)) + 1;
+            }
+        }
+    }
+
+    bool compute(const AIProgram& aiprog, sead::Heap* heap) {
+        s32 max_slots = 0;
+        const auto count_slots = [&](const auto& defs) {
+            for (const auto& def : defs)
+                max_slots += def.mSInstParams.size();
+        };
+        count_slots(aiprog.getAIs());
+        count_slots(aiprog.getActions());
+        count_slots(aiprog.getBehaviors());
+        count_slots(aiprog.getQueries());
+        if (max_slots != 0 && !slots.tryAllocBuffer(max_slots, heap))
+            return false;
+
+        addDefs(aiprog.getAIs(), AIDefType::AI);
+        addDefs(aiprog.getActions(), AIDefType::Action);
+        addDefs(aiprog.getBehaviors(), AIDefType::Behavior);
+        addDefs(aiprog.getQueries(), AIDefType::Query);
+        num_u16 += u32(aiprog.getDemoAiActionIndices().size());
+        num_u8 += u32(aiprog.getDemoBehaviorIndices().size());
+        return true;
+    }
+
+    sead::Buffer<ImageParamSlot> slots;
+    s32 num_slots = 0;
+    u32 num_defs = 0;
+    u32 num_params = 0;
+    u32 num_u16 = 0;
+    u32 num_u8 = 0;
+    u32 strings_size = 0;
+};
+
+/// Writes the sections of an AIProgramImage, following an ImageLayout.
+struct ImageWriter {
+    ImageWriter(const ImageLayout& layout_, u8* image, const u8* data_, u32 size_)
+        : layout(layout_), data(data_), size(size_) {
+        defs = reinterpret_cast<Image::Def*>(image + sizeof(Image::Header));
+        params = reinterpret_cast<Image::Param*>(defs + layout.num_defs);
+        u16_pool = reinterpret_cast<u16*>(params + layout.num_params);
+        u8_pool = reinterpret_cast<u8*>(u16_pool + layout.num_u16);
+        strings = reinterpret_cast<char*>(u8_pool + layout.num_u8);
+    }
+
+    u32 getSourceOffset(const char* str) const {
+        const auto* ptr = reinterpret_cast<const u8*>(str);
+        if (!str || ptr < data || ptr >= data + size)
+            return Image::NullOffset;
+        return u32(ptr - data);
+    }
+
+    u32 addString(const char* str) {
+        const u32 offset = strings_size;
+        const u32 length = u32(std::strlen(str)) + 1;
+        std::memcpy(strings + offset, str, length);
+        strings_size += length;
+        return offset;
+    }
+
+    const ImageLayout& layout;
+    const u8* data;
+    u32 size;
+
+    Image::Def* defs;
+    Image::Param* params;
+    u16* u16_pool;
+    u8* u8_pool;
+    char* strings;
+
+    s32 num_slots = 0;
+    u32 num_defs = 0;
+    u32 num_params = 0;
+    u32 num_u16 = 0;
+    u32 num_u8 = 0;
+    u32 strings_size = 0;
+};
+
+void writeImageParam(ImageWriter& writer, s32 idx, const ImageParamSlot& slot,
+                     const agl::utl::ParameterBase& param) {
+    Image::Param out{};
+    out.idx = u16(idx);
+    switch (slot.type) {
+    case AIDefParamType::String:
+    case AIDefParamType::Tree:
+        out.type = Image::ParamType::String;
+        out.value[0] = writer.getSourceOffset(param.ptrT<char>());
+        break;
+    case AIDefParamType::UInt:
+        out.type = Image::ParamType::UInt;
+        std::memcpy(out.value, param.ptrT<u32>(), sizeof(u32));
+        break;
+    case AIDefParamType::Int:
+        out.type = Image::ParamType::Int;
+        std::memcpy(out.value, param.ptrT<s32>(), sizeof(s32));
+        break;
+    case AIDefParamType::Float:
+        out.type = Image::ParamType::Float;
+        std::memcpy(out.value, param.ptrT<f32>(), sizeof(f32));
+        break;
+    case AIDefParamType::Vec3:
+        out.type = Image::ParamType::Vec3;
+        std::memcpy(out.value, param.ptrT<sead::Vector3f>(), sizeof(sead::Vector3f));
+        break;
+    case AIDefParamType::Bool:
+        out.type = Image::ParamType::Bool;
+        out.value[0] = *param.ptrT<bool>();
+        break;
+    default:
+        break;
+    }
+    out.name = writer.addString(slot.name);
+    writer.params[writer.num_params++] = out;
+}
+
+template <typename T>
+void writeImageDefs(ImageWriter& writer, const sead::Buffer<T>& defs) {
+    for (const auto& def : defs) {
+        Image::Def out{};
+        out.class_name = writer.getSourceOffset(def.mClassName);
+        out.name = writer.getSourceOffset(def.mName);
+        out.group_name = Image::NullOffset;
+
+        if constexpr (std::is_same<T, AIProgram::AIActionDef>()) {
+            out.group_name = writer.getSourceOffset(def.mGroupName);
+            out.first_child = writer.num_u16;
+            out.num_children = u16(def.mChildIndices.size());
+            for (const u16 idx : def.mChildIndices)
+                writer.u16_pool[writer.num_u16++] = idx;
+            out.first_behavior = writer.num_u8;
+            out.num_behaviors = u16(def.mBehaviorIndices.size());
+            for (const u8 idx : def.mBehaviorIndices)
+                writer.u8_pool[writer.num_u8++] = idx;
+            out.param1 = def.mTriggerAction;
+            out.param2 = def.mDynamicParamChild;
+        } else if constexpr (std::is_same<T, AIProgram::BehaviorDef>()) {
+            out.param1 = def.mCalcTiming;
+            out.param2 = def.mNoStop;
+        }
+
+        out.first_param = writer.num_params;
+        out.num_sinst_params = u16(def.mSInstParams.size());
+        for (s32 i = 0; i < def.mSInstParams.size(); ++i) {
+            const auto& slot = writer.layout.slots[writer.num_slots++];
+            if (slot.name)
+                writeImageParam(writer, i, slot, *def.mSInstParams[i]);
+        }
+        out.num_params = u16(writer.num_params - out.first_param);
+
+        writer.defs[writer.num_defs++] = out;
+    }
+}
+
+/// Serialises a program that has just been parsed directly into the image cache.
+void saveImage(AIProgramImageCache* cache, const AIProgram& aiprog, u32 hash, const u8* data,
+               u32 size, sead::Heap* heap) {
+    ImageLayout layout;
+    if (!layout.compute(aiprog, heap))
+        return;
+
+    Image::Header header{};
+    header.magic = Image::Magic;
+    header.version = Image::Version;
+    header.source_hash = hash;
+    header.source_size = size;
+    header.image_size = Image::calcSize(layout.num_defs, layout.num_params, layout.num_u16,
+                                        layout.num_u8, layout.strings_size);
+    header.num_defs[u8(Image::Kind::AI)] = u32(aiprog.getAIs().size());
+    header.num_defs[u8(Image::Kind::Action)] = u32(aiprog.getActions().size());
+    header.num_defs[u8(Image::Kind::Behavior)] = u32(aiprog.getBehaviors().size());
+    header.num_defs[u8(Image::Kind::Query)] = u32(aiprog.getQueries().size());
+    header.num_params = layout.num_params;
+    header.num_u16 = layout.num_u16;
+    header.num_u8 = layout.num_u8;
+    header.strings_size = layout.strings_size;
+    header.num_demo_ai_action_indices = u32(aiprog.getDemoAiActionIndices().size());
+    header.num_demo_behavior_indices = u32(aiprog.getDemoBehaviorIndices().size());
+
+    cache->addImage(header, [&](u8* image) {
+        std::memcpy(image, &header, sizeof(header));
+
+        ImageWriter writer{layout, image, data, size};
+        writeImageDefs(writer, aiprog.getAIs());
+        writeImageDefs(writer, aiprog.getActions());
+        writeImageDefs(writer, aiprog.getBehaviors());
+        writeImageDefs(writer, aiprog.getQueries());
+        for (const u16 idx : aiprog.getDemoAiActionIndices())
+            writer.u16_pool[writer.num_u16++] = idx;
+        for (const u8 idx : aiprog.getDemoBehaviorIndices())
+            writer.u8_pool[writer.num_u8++] = idx;
+    });
+
+    layout.slots.freeBuffer();
+}
+
+/// Read-only view of an image. Must only be created for images that passed validation.
+struct ImageReader {
+    ImageReader(const u8* image, const u8* data_) : data(data_) {
+        std::memcpy(&header, image, sizeof(header));
+        defs = reinterpret_cast<const Image::Def*>(image + sizeof(Image::Header));
+        u32 num_defs = 0;
+        for (const u32 num : header.num_defs)
+            num_defs += num;
+        params = reinterpret_cast<const Image::Param*>(defs + num_defs);
+        u16_pool = reinterpret_cast<const u16*>(params + header.num_params);
+        u8_pool = reinterpret_cast<const u8*>(u16_pool + header.num_u16);
+        strings = reinterpret_cast<const char*>(u8_pool + header.num_u8);
+    }
+
+    const Image::Def* getDefs(Image::Kind kind) const {
+        const Image::Def* ptr = defs;
+        for (s32 i = 0; i < s32(kind); ++i)
+            ptr += header.num_defs[i];
+        return ptr;
+    }
+
+    const char* getSourceString(u32 offset) const {
+        return offset == Image::NullOffset ? "" : reinterpret_cast<const char*>(data + offset);
+    }
+
+    const u8* data;
+    Image::Header header;
+    const Image::Def* defs;
+    const Image::Param* params;
+    const u16* u16_pool;
+    const u8* u8_pool;
+    const char* strings;
+};
+
+bool isValidSourceString(u32 offset, const u8* data, u32 size) {
+    return offset == Image::NullOffset ||
+           (offset < size && std::memchr(data + offset, '\0', size - offset) != nullptr);
+}
+
+bool validateImage(const u8* image, u32 image_size, u32 hash, const u8* data, u32 size) {
+    if (image_size < sizeof(Image::Header))
+        return false;
+
+    Image::Header header;
+    std::memcpy(&header, image, sizeof(header));
+    if (header.magic != Image::Magic || header.version != Image::Version ||
+        header.source_hash != hash || header.source_size != size ||
+        header.image_size != image_size) {
+        return false;
+    }
+
+    u64 num_defs = 0;
+    for (const u32 num : header.num_defs)
+        num_defs += num;
+
+    const u64 expected_size = sizeof(Image::Header) + sizeof(Image::Def) * num_defs +
+                              sizeof(Image::Param) * u64(header.num_params) +
+                              sizeof(u16) * u64(header.num_u16) + u64(header.num_u8) +
+                              u64(header.strings_size);
+    if (expected_size != image_size ||
+        header.num_demo_ai_action_indices > header.num_u16 ||
+        header.num_demo_behavior_indices > header.num_u8) {
+        return false;
+    }
+
+    const ImageReader reader{image, data};
+    if (header.strings_size != 0 && reader.strings[header.strings_size - 1] != '\0')
+        return false;
+
+    for (u64 i = 0; i < num_defs; ++i) {
+        const auto& def = reader.defs[i];
+        if (!isValidSourceString(def.class_name, data, size) ||
+            !isValidSourceString(def.name, data, size) ||
+            !isValidSourceString(def.group_name, data, size) ||
+            u64(def.first_param) + def.num_params > header.num_params ||
+            u64(def.first_child) + def.num_children > header.num_u16 ||
+            u64(def.first_behavior) + def.num_behaviors > header.num_u8) {
+            return false;
+        }
+
+        for (u32 j = 0; j < def.num_params; ++j) {
+            const auto& param = reader.params[def.first_param + j];
+            if (param.idx >= def.num_sinst_params || param.type > Image::ParamType::Bool ||
+                param.name >= header.strings_size) {
+                return false;
+            }
+            if (param.type == Image::ParamType::String &&
+                !isValidSourceString(param.value[0], data, size)) {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+template <typename T>
+bool copyImageIndices(sead::Buffer<T>& buffer, const T* indices, u32 num, sead::Heap* heap) {
+    if (num == 0)
+        return true;
+    if (!buffer.tryAllocBuffer(num, heap))
+        return false;
+    std::memcpy(buffer.getBufferPtr(), indices, sizeof(T) * num);
+    return true;
+}
+
+bool loadImageParam(AIProgram::Definition* def, const Image::Param& param, const char* name,
+                    const ImageReader& reader, sead::Heap* heap) {
+    switch (param.type) {
+    case Image::ParamType::String:
+        return def->addSInstParam_<sead::SafeString>(param.idx, name, heap,
+                                                     reader.getSourceString(param.value[0]));
+    case Image::ParamType::UInt: {
+        u32 value;
+        std::memcpy(&value, param.value, sizeof(value));
+        return def->addSInstParam_<u32>(param.idx, name, heap, value);
+    }
+    case Image::ParamType::Int: {
+        s32 value;
+        std::memcpy(&value, param.value, sizeof(value));
+        return def->addSInstParam_<s32>(param.idx, name, heap, value);
+    }
+    case Image::ParamType::Float: {
+        f32 value;
+        std::memcpy(&value, param.value, sizeof(value));
+        return def->addSInstParam_<f32>(param.idx, name, heap, value);
+    }
+    case Image::ParamType::Vec3: {
+        sead::Vector3f value;
+        std::memcpy(&value, param.value, sizeof(value));
+        return def->addSInstParam_<sead::Vector3f>(param.idx, name, heap, value);
+    }
+    case Image::ParamType::Bool:
+        return def->addSInstParam_<bool>(param.idx, name, heap, param.value[0] != 0);
+    }
+    return false;
+}
+
+/// @param names Copy of the image string pool that lives as long as the program.
+template <typename T>
+bool loadImageDefs(sead::Buffer<T>& defs, agl::utl::ParameterList& target_list,
+                   const char* type_name, Image::Kind kind, const ImageReader& reader,
+                   const char* names, sead::Heap* heap) {
+    const u32 num = reader.header.num_defs[u8(kind)];
+    if (num == 0)
+        return true;
+
+    if (!defs.tryAllocBuffer(num, heap))
+        return false;
+
+    sead::FixedSafeString<32> list_name{type_name};
+    list_name.append("_");
+    const s32 trim_length = list_name.calcLength();
+
+    const Image::Def* image_defs = reader.getDefs(kind);
+    for (auto it = defs.begin(), end = defs.end(); it != end; ++it) {
+        const auto& image_def = image_defs[it.getIndex()];
+
+        list_name.trim(trim_length);
+        list_name.appendWithFormat("%d", it.getIndex());
+        target_list.addList(&it->mList, list_name);
+
+        it->mClassName = reader.getSourceString(image_def.class_name);
+        it->mName = reader.getSourceString(image_def.name);
+
+        if constexpr (std::is_same<T, AIProgram::AIActionDef>()) {
+            it->mGroupName = reader.getSourceString(image_def.group_name);
+            if (!copyImageIndices(it->mChildIndices, reader.u16_pool + image_def.first_child,
+                                  image_def.num_children, heap) ||
+                !copyImageIndices(it->mBehaviorIndices, reader.u8_pool + image_def.first_behavior,
+                                  image_def.num_behaviors, heap)) {
+                return false;
+            }
+            it->mTriggerAction = image_def.param1;
+            it->mDynamicParamChild = image_def.param2;
+        } else if constexpr (std::is_same<T, AIProgram::BehaviorDef>()) {
+            it->mCalcTiming = image_def.param1;
+            it->mNoStop = image_def.param2;
+        }
+
+        if (image_def.num_sinst_params != 0) {
+            if (!it->mSInstParams.tryAllocBuffer(image_def.num_sinst_params, heap))
+                return false;
+
+            for (auto*& param : it->mSInstParams)
+                param = nullptr;
+
+            for (u32 i = 0; i < image_def.num_params; ++i) {
+                const auto& param = reader.params[image_def.first_param + i];
+                if (!loadImageParam(&*it, param, names + param.name, reader, heap))
+                    return false;
+            }
+        }
+
+        it->mList.addObj(&it->mSInstObj, "SInst");
+    }
+
+    return true;
+}
+
+}  // namespace
+
+AIProgram::ImageLoadResult AIProgram::loadImage_(const u8* image, u32 image_size, u32 hash,
+                                                 const u8* data, u32 size, sead::Heap* heap) {
+    if (!validateImage(image, image_size, hash, data, size))
+        return ImageLoadResult::Invalid;
+
+    const ImageReader reader{image, data};
+    const auto& header = reader.header;
+
+    // Parameter names must outlive the cached image, which may be evicted at any time.
+    char* names = nullptr;
+    if (header.strings_size != 0) {
+        names = new (heap, std::nothrow_t()) char[header.strings_size];
+        if (!names)
+            return ImageLoadResult::AllocFailed;
+        std::memcpy(names, reader.strings, header.strings_size);
+    }
+
+    if (!loadImageDefs(mAIs, mParamListAI, "AI", Image::Kind::AI, reader, names, heap) ||
+        !loadImageDefs(mActions, mParamListAction, "Action", Image::Kind::Action, reader, names,
+                       heap) ||
+        !loadImageDefs(mBehaviors, mParamListBehavior, "Behavior", Image::Kind::Behavior, reader,
+                       names, heap) ||
+        !loadImageDefs(mQueries, mParamListQuery, "Query", Image::Kind::Query, reader, names,
+                       heap)) {
+        return ImageLoadResult::AllocFailed;
+    }
+
+    if (mAIs.size() != 0)
+        addList(&mParamListAI, "AI");
+    if (mActions.size() != 0)
+        addList(&mParamListAction, "Action");
+    if (mBehaviors.size() != 0)
+        addList(&mParamListBehavior, "Behavior");
+    if (mQueries.size() != 0)
+        addList(&mParamListQuery, "Query");
+
+    const u32 num_demo_ai_actions = header.num_demo_ai_action_indices;
+    const u32 num_demo_behaviors = header.num_demo_behavior_indices;
+    if (!copyImageIndices(mDemoAIActionIndices,
+                          reader.u16_pool + header.num_u16 - num_demo_ai_actions,
+                          num_demo_ai_actions, heap) ||
+        !copyImageIndices(mDemoBehaviorIndices, reader.u8_pool + header.num_u8 - num_demo_behaviors,
+                          num_demo_behaviors, heap)) {
+        return ImageLoadResult::AllocFailed;
+    }
+
+    return ImageLoadResult::Loaded;
+}
+
 // the parameter iteration loops in parseAIActionIdx and parseBehaviorIdx
 #ifdef NON_MATCHING
-bool AIProgram::parse_(u8* data, size_t, sead::Heap* parent_heap) {
+bool AIProgram::parse_(u8* data, size_t size, sead::Heap* parent_heap) {
     if (data) {
         auto* heap = util::tryCreateDualHeap(parent_heap);
         mHeap = heap;
@@ -80,6 +588,26 @@ bool AIProgram::parse_(u8* data, size_t, sead::Heap* parent_heap) {
         heap->enableWarning(false);
         heap = mHeap;
 
+        // The same programs are loaded again on every area transition, so try to reuse the
+        // result of a previous parse first. Static parameter values are stored in the image,
+        // so the archive does not need to be applied in that case.
+        auto* image_cache = AIProgramImageCache::instance();
+        const u32 hash = image_cache ? AIProgramImage::calcSourceHash(data, u32(size)) : 0;
+        if (image_cache) {
+            auto result = ImageLoadResult::Invalid;
+            const bool found =
+                image_cache->withImage(hash, u32(size), [&](const u8* image, u32 image_size) {
+                    result = loadImage_(image, image_size, hash, data, u32(size), heap);
+                });
+
+            if (found && result != ImageLoadResult::Invalid) {
+                mHeap->adjust();
+                return result == ImageLoadResult::Loaded;
+            }
+            if (found)
+                image_cache->rejectImage(hash, u32(size));
+        }
+
         agl::utl::ResParameterArchive archive{data};
         const auto root = archive.getRootList();
 
@@ -102,6 +630,9 @@ bool AIProgram::parse_(u8* data, size_t, sead::Heap* parent_heap) {
         }
 
         applyResParameterArchive(agl::utl::ResParameterArchive{data});
+
+        if (image_cache)
+            saveImage(image_cache, *this, hash, data, u32(size), heap);
     }
 
     mHeap->adjust();
@@ -330,6 +861,27 @@ AIProgram::Definition::findSInstParam(const sead::SafeString& name) const {
     return findSInstParam(agl::utl::ParameterBase::calcHash(name));
 }
 
+const agl::utl::ParameterBase*
+AIProgram::Definition::findSInstParam(act::ai::StaticParamSlot* slot) const {
+    const s32 cached_idx = slot->index;
+    if (cached_idx >= 0 && cached_idx < mSInstParams.size()) {
+        const auto* param = mSInstParams[cached_idx];
+        if (param && param->getNameHash() == slot->hash)
+            return param;
+    }
+
+    for (s32 i = 0, n = mSInstParams.size(); i < n; ++i) {
+        const auto* param = mSInstParams[i];
+        if (param && param->getNameHash() == slot->hash) {
+            // All definitions of a class share the same layout, so this is usually only
+            // reached once per slot.
+            slot->index.store(i);
+            return param;
+        }
+    }
+    return nullptr;
+}
+
 bool AIProgram::getSInstParam(const char** value, const AIProgram::Definition& def,
                               const sead::SafeString& param_name) const {
     const auto* param = def.findSInstParam(param_name);
@@ -376,33 +928,79 @@ bool AIProgram::getSInstParam(const bool** value, const AIProgram::Definition& d
     return getSInstParam_(value, def, param_name, agl::utl::ParameterType::Bool, &sDefault);
 }
 
+bool AIProgram::getSInstParam(const char** value, const Definition& def,
+                              act::ai::StaticParamSlot* slot) const {
+    return getSInstParam_(value, def.findSInstParam(slot), agl::utl::ParameterType::StringRef,
+                          &sead::SafeString::cNullChar);
+}
+
+bool AIProgram::getSInstParam(sead::SafeString* value, const Definition& def,
+                              act::ai::StaticParamSlot* slot) const {
+    const char* str;
+    const bool found = getSInstParam(&str, def, slot);
+    *value = str;
+    return found;
+}
+
+bool AIProgram::getSInstParam(const s32** value, const Definition& def,
+                              act::ai::StaticParamSlot* slot) const {
+    static const s32 sDefault{};
+    return getSInstParam_(value, def.findSInstParam(slot), agl::utl::ParameterType::Int,
+                          &sDefault);
+}
+
+bool AIProgram::getSInstParam(const f32** value, const Definition& def,
+                              act::ai::StaticParamSlot* slot) const {
+    static const f32 sDefault{};
+    return getSInstParam_(value, def.findSInstParam(slot), agl::utl::ParameterType::F32,
+                          &sDefault);
+}
+
+bool AIProgram::getSInstParam(const sead::Vector3f** value, const Definition& def,
+                              act::ai::StaticParamSlot* slot) const {
+    return getSInstParam_(value, def.findSInstParam(slot), agl::utl::ParameterType::Vec3,
+                          &sead::Vector3f::zero);
+}
+
+bool AIProgram::getSInstParam(const bool** value, const Definition& def,
+                              act::ai::StaticParamSlot* slot) const {
+    static const bool sDefault{};
+    return getSInstParam_(value, def.findSInstParam(slot), agl::utl::ParameterType::Bool,
+                          &sDefault);
+}
+
 bool AIProgram::parseDefParams(AIProgram::Definition* def, void* buffer, sead::Heap* heap,
                                const agl::utl::ResParameterList& res, u16* param1, u16* param2) {
     const auto sinst_obj = agl::utl::getResParameterObj(res, "SInst");
     const s32 sinst_num_params = sinst_obj.ptr() ? sinst_obj.getNum() : 0;
 
     AIDef aidef;
+    AIDefType type;
 
     if (&mAIs == buffer) {
-        AIClassDef::instance()->getDef(&aidef, def->mClassName, AIDefInstParamKind::Static,
-                                       AIDefType::AI);
+        type = AIDefType::AI;
+        AIClassDef::instance()->getDef(&aidef, def->mClassName, AIDefInstParamKind::Static, type);
         *param1 = aidef.trigger_action;
         *param2 = aidef.dynamic_param_child;
     } else if (&mActions == buffer) {
-        AIClassDef::instance()->getDef(&aidef, def->mClassName, AIDefInstParamKind::Static,
-                                       AIDefType::Action);
+        type = AIDefType::Action;
+        AIClassDef::instance()->getDef(&aidef, def->mClassName, AIDefInstParamKind::Static, type);
         *param1 = aidef.trigger_action;
         *param2 = 0;
     } else if (&mBehaviors == buffer) {
-        AIClassDef::instance()->getDef(&aidef, def->mClassName, AIDefInstParamKind::Static,
-                                       AIDefType::Behavior);
+        type = AIDefType::Behavior;
+        AIClassDef::instance()->getDef(&aidef, def->mClassName, AIDefInstParamKind::Static, type);
         *param1 = u16(aidef.calc_timing);
         *param2 = aidef.no_stop;
     } else {
-        AIClassDef::instance()->getDef(&aidef, def->mClassName, AIDefInstParamKind::Static,
-                                       AIDefType::Query);
+        type = AIDefType::Query;
+        AIClassDef::instance()->getDef(&aidef, def->mClassName, AIDefInstParamKind::Static, type);
     }
 
+    // SInst parameters are stored in AIClassDef order (see below), so the index of every static
+    // parameter key of the class is known now and loadParams_ never has to search for it.
+    act::ai::StaticParamSlotTable::resolve(type, def->mClassName, aidef);
+
     if (sinst_num_params != 0) {
         const auto num_params =
             aidef.num_params < sinst_num_params ? aidef.num_params : sinst_num_params;
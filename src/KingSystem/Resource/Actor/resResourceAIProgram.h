@@ -11,7 +11,8 @@
 
 namespace ksys::act::ai {
 enum class ActionType : int;
-}
+struct StaticParamSlot;
+}  // namespace ksys::act::ai
 
 namespace ksys::res {
 
@@ -21,6 +22,8 @@ public:
     struct Definition {
         const agl::utl::ParameterBase* findSInstParam(u32 name_hash) const;
         const agl::utl::ParameterBase* findSInstParam(const sead::SafeString& name) const;
+        /// Checks the index that is cached in the slot first, and updates it if needed.
+        const agl::utl::ParameterBase* findSInstParam(act::ai::StaticParamSlot* slot) const;
 
         template <typename T>
         bool addSInstParam_(s32 idx, const char* name, sead::Heap* heap, const T& value);
@@ -87,6 +90,19 @@ public:
     bool getSInstParam(const bool** value, const Definition& def,
                        const sead::SafeString& param_name) const;
 
+    bool getSInstParam(const char** value, const Definition& def,
+                       act::ai::StaticParamSlot* slot) const;
+    bool getSInstParam(sead::SafeString* value, const Definition& def,
+                       act::ai::StaticParamSlot* slot) const;
+    bool getSInstParam(const s32** value, const Definition& def,
+                       act::ai::StaticParamSlot* slot) const;
+    bool getSInstParam(const f32** value, const Definition& def,
+                       act::ai::StaticParamSlot* slot) const;
+    bool getSInstParam(const sead::Vector3f** value, const Definition& def,
+                       act::ai::StaticParamSlot* slot) const;
+    bool getSInstParam(const bool** value, const Definition& def,
+                       act::ai::StaticParamSlot* slot) const;
+
     void doCreate_(u8* buffer, u32 bufferSize, sead::Heap* heap) override;
     bool needsParse() const override { return true; }
 
@@ -100,6 +116,16 @@ private:
     bool parseDefParams(Definition* def, void* buffer, sead::Heap* heap,
                         const agl::utl::ResParameterList& res, u16* param1, u16* param2);
 
+    enum class ImageLoadResult {
+        Loaded,
+        /// The image does not match the archive or is corrupted.
+        Invalid,
+        AllocFailed,
+    };
+    /// Fills the program from a cached image (see AIProgramImage) instead of parsing the archive.
+    ImageLoadResult loadImage_(const u8* image, u32 image_size, u32 hash, const u8* data,
+                               u32 size, sead::Heap* heap);
+
     void finalize_() override;
     void finalizeAIActions(sead::Buffer<AIActionDef>& defs);
     void finalizeBehaviors();
@@ -108,6 +134,9 @@ private:
     template <typename T>
     bool getSInstParam_(const T** value, const Definition& def, const sead::SafeString& param_name,
                         agl::utl::ParameterType param_type, const T* default_value) const;
+    template <typename T>
+    static bool getSInstParam_(const T** value, const agl::utl::ParameterBase* param,
+                               agl::utl::ParameterType param_type, const T* default_value);
 
     sead::Heap* mHeap = nullptr;
     sead::SafeString mStr;
@@ -141,4 +170,16 @@ inline bool AIProgram::getSInstParam_(const T** value, const AIProgram::Definiti
     return true;
 }
 
+template <typename T>
+inline bool AIProgram::getSInstParam_(const T** value, const agl::utl::ParameterBase* param,
+                                      agl::utl::ParameterType param_type,
+                                      const T* default_value) {
+    if (!param || param->getParameterType() != param_type) {
+        *value = default_value;
+        return false;
+    }
+    *value = param->ptrT<T>();
+    return true;
+}
+
 }  // namespace ksys::res
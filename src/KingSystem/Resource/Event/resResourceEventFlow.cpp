@@ -1,5 +1,6 @@
 #include "KingSystem/Resource/Event/resResourceEventFlow.h"
 #include <evfl/ResEventFlowFile.h>
+#include "KingSystem/Event/evtFlowchartBindingCache.h"
 #include "KingSystem/Resource/resEntryFactory.h"
 #include "KingSystem/Resource/resSystem.h"
 
@@ -16,6 +17,9 @@ void EventFlowchart::doCreate_(u8* buffer, u32 buffer_size, sead::Heap* heap) {
 
 void EventFlowchart::onDestroy_() {
     if (m_res) {
+        // Cached bindings point into the flowchart, which is about to be unrelocated.
+        if (auto* cache = evt::FlowchartBindingCache::instance())
+            cache->invalidate(m_res);
         m_res->Unrelocate();
         m_res = nullptr;
     }
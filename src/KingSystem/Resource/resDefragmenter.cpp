@@ -0,0 +1,53 @@
+#include "KingSystem/Resource/resDefragmenter.h"
+#include "KingSystem/Resource/resResourceMgrTask.h"
+#include "KingSystem/Resource/resSystem.h"
+#include "KingSystem/Utils/SafeDelete.h"
+
+namespace ksys::res {
+
+SEAD_SINGLETON_DISPOSER_IMPL(Defragmenter)
+
+Defragmenter::Defragmenter() = default;
+
+Defragmenter::~Defragmenter() {
+    if (mTask)
+        mTask->removeFromQueue();
+    util::safeDelete(mTask);
+}
+
+void Defragmenter::init(const InitArg& arg, sead::Heap* heap) {
+    mMaxBytesPerStep = arg.max_bytes_per_step;
+    mMinFragmentation = arg.min_fragmentation;
+    mStepFn.bind(this, &Defragmenter::step_);
+    mTask = new (heap) util::Task(heap);
+}
+
+void Defragmenter::calc() {
+    auto* mgr = ResourceMgrTask::instance();
+    if (!mEnabled || !mTask || !mgr || mgr->isCompactionStopped())
+        return;
+
+    if (!mTask->canSubmitRequest())
+        return;
+
+    util::TaskRequest req;
+    req.mHasHandle = false;
+    req.mSynchronous = false;
+    req.mLaneId = u8(ResourceMgrTask::LaneId::_7);
+    req.mThread = mgr->getResourceMemoryThread();
+    req.mDelegate = &mStepFn;
+    req.mName = "Defragmenter::step";
+    mTask->submitRequest(req);
+}
+
+bool Defragmenter::step_(void*) {
+    const u32 size =
+        ResourceMgrTask::instance()->defragMostFragmentedArena(mMinFragmentation, mMaxBytesPerStep);
+    mLastEvictedSize.store(size);
+    mTotalEvictedSize += size;
+    if (size != 0 && returnFalse())
+        stubbedLogFunction();
+    return true;
+}
+
+}  // namespace ksys::res
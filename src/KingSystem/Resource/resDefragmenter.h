@@ -0,0 +1,63 @@
+#pragma once
+
+#include <basis/seadTypes.h>
+#include <heap/seadDisposer.h>
+#include <thread/seadAtomic.h>
+#include "KingSystem/Utils/Thread/Task.h"
+#include "KingSystem/Utils/Types.h"
+
+namespace ksys::res {
+
+/// Incrementally compacts OverlayArena heaps in the background.
+///
+/// Every frame, at most one defragmentation step is scheduled on the resource memory thread.
+/// A step picks the most fragmented arena and evicts cached resource units that are no longer
+/// referenced and that border free blocks, so that those blocks can coalesce and long play
+/// sessions do not end up running out of arena memory because of fragmentation. A step stops
+/// once the arena is no longer considered fragmented or after a bounded number of bytes.
+///
+/// Resources are not moved in place: users may hold raw pointers to a resource they have
+/// acquired, so only units that nothing references are touched.
+class Defragmenter {
+    SEAD_SINGLETON_DISPOSER(Defragmenter)
+    Defragmenter();
+    virtual ~Defragmenter();
+
+public:
+    struct InitArg {
+        /// Maximum number of bytes to evict per step.
+        u32 max_bytes_per_step = 0x40000;
+        /// Arenas whose fragmentation is below this value are left untouched.
+        f32 min_fragmentation = 0.25;
+    };
+
+    void init(const InitArg& arg, sead::Heap* heap);
+
+    /// Schedules a defragmentation step if the previous one has finished.
+    /// Called once per frame by the resource system.
+    void calc();
+
+    bool isEnabled() const { return mEnabled; }
+    void setEnabled(bool enabled) { mEnabled = enabled; }
+
+    u32 getMaxBytesPerStep() const { return mMaxBytesPerStep; }
+    void setMaxBytesPerStep(u32 size) { mMaxBytesPerStep = size; }
+
+    /// @return the number of bytes that were evicted by the last step.
+    u32 getLastEvictedSize() const { return mLastEvictedSize; }
+    /// @return the number of bytes that have been evicted since init.
+    u64 getTotalEvictedSize() const { return mTotalEvictedSize; }
+
+private:
+    bool step_(void* userdata);
+
+    util::Task* mTask = nullptr;
+    util::TaskDelegateT<Defragmenter> mStepFn;
+    u32 mMaxBytesPerStep = 0;
+    f32 mMinFragmentation = 0.0;
+    sead::Atomic<u32> mLastEvictedSize = 0;
+    u64 mTotalEvictedSize = 0;
+    bool mEnabled = true;
+};
+
+}  // namespace ksys::res
@@ -7,11 +7,13 @@
 #include "KingSystem/Framework/frmWorkerSupportThreadMgr.h"
 #include "KingSystem/Resource/resCache.h"
 #include "KingSystem/Resource/resCompactedHeap.h"
+#include "KingSystem/Resource/resDefragmenter.h"
 #include "KingSystem/Resource/resEntryFactory.h"
 #include "KingSystem/Resource/resMemoryTask.h"
 #include "KingSystem/Resource/resSystem.h"
 #include "KingSystem/Resource/resTextureHandleList.h"
 #include "KingSystem/Resource/resTextureHandleMgr.h"
+#include "KingSystem/System/MemoryProfiler.h"
 #include "KingSystem/System/OverlayArenaSystem.h"
 #include "KingSystem/Utils/SafeDelete.h"
 #include "KingSystem/Utils/Thread/GameTaskThread.h"
@@ -151,6 +153,25 @@ f32 ResourceMgrTask::getDefragProgress() const {
     return f32(_4cc) / f32(_4c8);
 }
 
+u32 ResourceMgrTask::defragMostFragmentedArena(f32 min_fragmentation, u32 max_bytes) {
+    auto lock = sead::makeScopedLock(mArenasCS);
+
+    OverlayArena* target = nullptr;
+    f32 max_fragmentation = min_fragmentation;
+    for (OverlayArena& arena : mArenas) {
+        const f32 fragmentation = arena.getFragmentation();
+        if (fragmentation >= max_fragmentation) {
+            max_fragmentation = fragmentation;
+            target = &arena;
+        }
+    }
+
+    if (!target)
+        return 0;
+
+    return target->evictUnits(max_bytes, min_fragmentation);
+}
+
 void ResourceMgrTask::registerFactory(sead::ResourceFactory* factory,
                                       const sead::SafeString& name) {
     auto lock = sead::makeScopedLock(mFactoryCS);
@@ -292,6 +313,21 @@ void ResourceMgrTask::requestClearCache(ResourceUnit** p_unit, util::Task* task)
     *p_unit = nullptr;
 }
 
+bool ResourceMgrTask::requestEvictUnit(ResourceUnit* unit) {
+    // Held until the unit is deregistered so that it cannot be deleted in between.
+    auto lock = sead::makeScopedLock(mUnitsCS);
+
+    ResourceUnit* ptr = unit;
+    requestClearCache(&ptr);
+    // The pointer is only reset if a request was submitted.
+    if (ptr)
+        return false;
+
+    if (unit->isLinkedToResourceMgr())
+        mUnits.erase(unit);
+    return true;
+}
+
 void ResourceMgrTask::requestClearCacheForSync(ResourceUnit** p_unit, bool clear_immediately,
                                                bool delete_immediately) {
     if (!p_unit || !*p_unit || !(*p_unit)->isStatusFlag8000Set()) {
@@ -491,6 +527,7 @@ void ResourceMgrTask::updateResourceArenasFlag8() {
 // branching
 #ifdef NON_MATCHING
 sead::Heap* ResourceMgrTask::makeHeapForUnit(const MakeHeapArg& arg) {
+    MemoryProfiler::ScopedTag tag("Resource");
     const auto heap_size = arg.heap_size;
     const auto path = arg.path;
 
@@ -671,6 +708,8 @@ void ResourceMgrTask::systemCalc_() {
 
     mTexHandleMgr->preCalc();
     updateCompaction();
+    if (auto* defragmenter = Defragmenter::instance())
+        defragmenter->calc();
     mTexHandleMgr->calc();
 }
 
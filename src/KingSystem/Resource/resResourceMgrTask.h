@@ -123,6 +123,13 @@ public:
     bool isDefragDone() const;
     f32 getDefragProgress() const;
 
+    /// Evicts unreferenced cached resource units from the most fragmented registered arena
+    /// (see OverlayArena::evictUnits).
+    /// @param min_fragmentation  Arenas that are less fragmented than this are left untouched.
+    /// @param max_bytes  Maximum number of bytes to evict.
+    /// @return the number of bytes that were evicted.
+    u32 defragMostFragmentedArena(f32 min_fragmentation, u32 max_bytes);
+
     void registerFactory(sead::ResourceFactory* factory, const sead::SafeString& name);
     void unregisterFactory(sead::ResourceFactory* factory);
 
@@ -158,6 +165,10 @@ public:
     void deregisterUnit(ResourceUnit* unit);
 
     void requestClearCache(ResourceUnit** p_unit, util::Task* task = nullptr);
+    /// Requests the cache of an unreferenced unit to be cleared, and deregisters the unit
+    /// if the request could be submitted.
+    /// @return whether the request was submitted.
+    bool requestEvictUnit(ResourceUnit* unit);
     void requestClearCacheForSync(ResourceUnit** p_unit, bool clear_immediately,
                                   bool delete_immediately);
 
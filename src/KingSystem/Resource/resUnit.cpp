@@ -409,4 +409,10 @@ bool ResourceUnit::isStatusFlag10000Set() const {
     return mStatusFlags.isOn(StatusFlag::_10000);
 }
 
+bool ResourceUnit::isEvictable() const {
+    if (!mHeap || !isLinkedToResourceMgr() || isStatusFlag10000Set() || isStatus1())
+        return false;
+    return getRefCount() == 0 && isStatusFlag8000Set() && mTask3.canSubmitRequest();
+}
+
 }  // namespace ksys::res
@@ -131,6 +131,9 @@ public:
 
     /// Destroys the underlying resource and reallocates it for defragmentation purposes.
     void reallocate();
+    /// Whether the unit is only kept alive by the resource cache, i.e. it is not referenced by
+    /// any Handle and can be cleared without waiting for anything.
+    bool isEvictable() const;
 
     u32 determineHeapSize();
     u32 determineHeapSize(const sead::SafeString& path, bool flag4, bool flag1, bool flag2);
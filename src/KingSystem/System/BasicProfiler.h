@@ -1,13 +1,22 @@
 #pragma once
 
+#include "KingSystem/System/Profiler.h"
+
 namespace ksys {
 
 class BasicProfiler {
 public:
+    /// Also records the scope in the per-thread Profiler when it is enabled.
     class Scope {
     public:
-        explicit Scope(const char* description) : mDescription(description) { push(description); }
-        ~Scope() { pop(mDescription); }
+        explicit Scope(const char* description) : mDescription(description) {
+            push(description);
+            Profiler::begin(description);
+        }
+        ~Scope() {
+            Profiler::end(mDescription);
+            pop(mDescription);
+        }
         Scope(const Scope&) = delete;
         auto operator=(const Scope&) = delete;
 
@@ -1,13 +1,375 @@
 #include "KingSystem/System/MemoryProfiler.h"
+#include <algorithm>
+#include <filedevice/seadFileDeviceMgr.h>
+#include <heap/seadHeap.h>
+#include <math/seadMathCalcCommon.h>
+#include <new>
+#include <prim/seadScopedLock.h>
+#include <thread/seadAtomic.h>
+#include <thread/seadCriticalSection.h>
+#include "KingSystem/Utils/Thread/ThreadSlot.h"
 
 namespace ksys {
 
 SEAD_SINGLETON_DISPOSER_IMPL(MemoryProfiler)
 
+namespace {
+
+struct TrackedHeap {
+    sead::Atomic<const sead::Heap*> heap;
+    MemoryProfiler::HeapType type;
+    sead::Atomic<u32> num_allocs;
+    sead::Atomic<u32> num_frees;
+    sead::Atomic<u64> allocated_size;
+    sead::Atomic<u64> freed_size;
+    size_t peak_used_size;
+};
+
+struct TrackedTag {
+    sead::Atomic<const char*> name;
+    sead::Atomic<u32> num_allocs;
+    sead::Atomic<u32> num_frees;
+    sead::Atomic<u64> allocated_size;
+    sead::Atomic<u64> freed_size;
+};
+
+/// Records the free of a sub-heap when it is destroyed. Heaps call the destructor of their
+/// disposers when they are destroyed, but the storage is owned by MemoryProfilerState.
+class SubHeapRecorder : public sead::IDisposer {
+public:
+    SubHeapRecorder(sead::Heap* child, const sead::Heap* parent, TrackedTag* tag, s32 idx)
+        : sead::IDisposer(child, HeapNullOption::DoNotAppendDisposerIfNoHeapSpecified),
+          mParent(parent), mTag(tag), mSize(child->getSize()), mIdx(idx) {}
+    ~SubHeapRecorder() override;
+
+    void disableRecording() { mParent = nullptr; }
+
+private:
+    const sead::Heap* mParent;
+    TrackedTag* mTag;
+    size_t mSize;
+    s32 mIdx;
+};
+
+struct MemoryProfilerState {
+    TrackedHeap heaps[MemoryProfiler::MaxHeaps]{};
+    sead::Atomic<s32> num_heaps = 0;
+    TrackedTag tags[MemoryProfiler::MaxTags]{};
+    sead::Atomic<s32> num_tags = 0;
+    /// Index of the innermost tag of each thread, or -1.
+    s32 current_tags[util::MaxThreadSlots];
+
+    alignas(SubHeapRecorder) u8 sub_heaps[MemoryProfiler::MaxSubHeaps][sizeof(SubHeapRecorder)];
+    bool sub_heap_in_use[MemoryProfiler::MaxSubHeaps]{};
+    /// Guards sub_heap_in_use. Sub-heaps are created and destroyed rarely enough for a lock.
+    sead::CriticalSection sub_heaps_cs;
+
+    u32 frame = 0;
+    MemoryProfiler::Snapshot snapshots[2]{};
+    s32 latest_snapshot_idx = 0;
+
+    MemoryProfilerState() {
+        for (auto& tag : current_tags)
+            tag = -1;
+    }
+
+    SubHeapRecorder* getSubHeap(s32 idx) {
+        return reinterpret_cast<SubHeapRecorder*>(sub_heaps[idx]);
+    }
+};
+
+MemoryProfilerState sMemoryProfiler;
+
+TrackedHeap* findHeap(const sead::Heap* heap) {
+    const s32 num_heaps = sead::Mathi::min(sMemoryProfiler.num_heaps, MemoryProfiler::MaxHeaps);
+    for (s32 i = 0; i < num_heaps; ++i) {
+        if (sMemoryProfiler.heaps[i].heap == heap)
+            return &sMemoryProfiler.heaps[i];
+    }
+    return nullptr;
+}
+
+/// @return the index of the tag, or -1 if there are too many tags.
+s32 findOrAddTag(const char* name) {
+    const s32 num_tags = sead::Mathi::min(sMemoryProfiler.num_tags, MemoryProfiler::MaxTags);
+    for (s32 i = 0; i < num_tags; ++i) {
+        if (sMemoryProfiler.tags[i].name == name)
+            return i;
+    }
+
+    if (num_tags >= MemoryProfiler::MaxTags)
+        return -1;
+
+    const s32 idx = sMemoryProfiler.num_tags.increment();
+    if (idx >= MemoryProfiler::MaxTags)
+        return -1;
+
+    sMemoryProfiler.tags[idx].name.store(name);
+    return idx;
+}
+
+TrackedTag* getCurrentTag() {
+    const s32 slot = util::getCurrentThreadSlot();
+    if (slot < 0 || sMemoryProfiler.current_tags[slot] < 0)
+        return nullptr;
+    return &sMemoryProfiler.tags[sMemoryProfiler.current_tags[slot]];
+}
+
+void addAlloc(TrackedHeap* heap, TrackedTag* tag, size_t size) {
+    if (heap) {
+        heap->num_allocs.increment();
+        heap->allocated_size.fetchAdd(size);
+    }
+    if (tag) {
+        tag->num_allocs.increment();
+        tag->allocated_size.fetchAdd(size);
+    }
+}
+
+void addFree(TrackedHeap* heap, TrackedTag* tag, size_t size) {
+    if (heap) {
+        heap->num_frees.increment();
+        heap->freed_size.fetchAdd(size);
+    }
+    if (tag) {
+        tag->num_frees.increment();
+        tag->freed_size.fetchAdd(size);
+    }
+}
+
+SubHeapRecorder::~SubHeapRecorder() {
+    if (mParent)
+        addFree(findHeap(mParent), mTag, mSize);
+
+    const auto lock = sead::makeScopedLock(sMemoryProfiler.sub_heaps_cs);
+    sMemoryProfiler.sub_heap_in_use[mIdx] = false;
+}
+
+}  // namespace
+
+u32 MemoryProfiler::sSnapshotInterval = 60;
+
+MemoryProfiler::ScopedTag::ScopedTag(const char* tag) {
+    const s32 slot = util::getCurrentThreadSlot();
+    if (slot < 0)
+        return;
+    mPreviousTag = sMemoryProfiler.current_tags[slot];
+    sMemoryProfiler.current_tags[slot] = findOrAddTag(tag);
+}
+
+MemoryProfiler::ScopedTag::~ScopedTag() {
+    const s32 slot = util::getCurrentThreadSlot();
+    if (slot < 0)
+        return;
+    sMemoryProfiler.current_tags[slot] = mPreviousTag;
+}
+
+MemoryProfiler::~MemoryProfiler() {
+    // Detach from the sub-heaps that are still alive, without recording anything.
+    for (s32 i = 0; i < MaxSubHeaps; ++i) {
+        if (!sMemoryProfiler.sub_heap_in_use[i])
+            continue;
+        SubHeapRecorder* recorder = sMemoryProfiler.getSubHeap(i);
+        recorder->disableRecording();
+        recorder->~SubHeapRecorder();
+    }
+}
+
 void MemoryProfiler::init(sead::Heap* heap) {
     mHeap = heap;
     _28 = nullptr;
     _30 = nullptr;
 }
 
+bool MemoryProfiler::trackHeap(const sead::Heap* heap, HeapType type) {
+    if (!heap || findHeap(heap))
+        return false;
+
+    // Reuse the slot of a heap that has been untracked, if possible.
+    for (s32 i = 0, n = sead::Mathi::min(sMemoryProfiler.num_heaps, MaxHeaps); i < n; ++i) {
+        auto& entry = sMemoryProfiler.heaps[i];
+        if (entry.heap.compareExchange(nullptr, heap)) {
+            entry.type = type;
+            return true;
+        }
+    }
+
+    const s32 idx = sMemoryProfiler.num_heaps.increment();
+    if (idx >= MaxHeaps)
+        return false;
+
+    auto& entry = sMemoryProfiler.heaps[idx];
+    entry.type = type;
+    entry.heap.store(heap);
+    return true;
+}
+
+void MemoryProfiler::untrackHeap(const sead::Heap* heap) {
+    TrackedHeap* entry = findHeap(heap);
+    if (!entry)
+        return;
+
+    entry->num_allocs.store(0);
+    entry->num_frees.store(0);
+    entry->allocated_size.store(0);
+    entry->freed_size.store(0);
+    entry->peak_used_size = 0;
+    entry->heap.store(nullptr);
+}
+
+void MemoryProfiler::recordAlloc(const sead::Heap* heap, size_t size) {
+    addAlloc(findHeap(heap), getCurrentTag(), size);
+}
+
+void MemoryProfiler::recordFree(const sead::Heap* heap, size_t size) {
+    addFree(findHeap(heap), getCurrentTag(), size);
+}
+
+void MemoryProfiler::trackSubHeap(const sead::Heap* parent, sead::Heap* child) {
+    if (!parent || !child)
+        return;
+
+    TrackedTag* tag = getCurrentTag();
+    addAlloc(findHeap(parent), tag, child->getSize());
+
+    const auto lock = sead::makeScopedLock(sMemoryProfiler.sub_heaps_cs);
+    for (s32 i = 0; i < MaxSubHeaps; ++i) {
+        if (sMemoryProfiler.sub_heap_in_use[i])
+            continue;
+        sMemoryProfiler.sub_heap_in_use[i] = true;
+        new (sMemoryProfiler.getSubHeap(i)) SubHeapRecorder(child, parent, tag, i);
+        return;
+    }
+    // Too many live sub-heaps: the free will not be recorded.
+}
+
+void MemoryProfiler::calc() {
+    const u32 frame = sMemoryProfiler.frame++;
+    if (sSnapshotInterval == 0 || frame % sSnapshotInterval != 0)
+        return;
+
+    sMemoryProfiler.latest_snapshot_idx ^= 1;
+    takeSnapshot(&sMemoryProfiler.snapshots[sMemoryProfiler.latest_snapshot_idx]);
+}
+
+void MemoryProfiler::takeSnapshot(Snapshot* snapshot) const {
+    snapshot->frame = sMemoryProfiler.frame;
+
+    snapshot->num_heaps = 0;
+    for (s32 i = 0, n = sead::Mathi::min(sMemoryProfiler.num_heaps, MaxHeaps); i < n; ++i) {
+        auto& entry = sMemoryProfiler.heaps[i];
+        const sead::Heap* heap = entry.heap;
+        if (!heap)
+            continue;
+
+        auto& stats = snapshot->heaps[snapshot->num_heaps++];
+        stats.heap = heap;
+        stats.type = entry.type;
+        stats.name = heap->getName();
+        stats.num_allocs = entry.num_allocs;
+        stats.num_frees = entry.num_frees;
+        stats.allocated_size = entry.allocated_size;
+        stats.freed_size = entry.freed_size;
+        stats.size = heap->getSize();
+
+        const size_t free_size = heap->getFreeSize();
+        stats.used_size = stats.size - free_size;
+        entry.peak_used_size = std::max(entry.peak_used_size, stats.used_size);
+        stats.peak_used_size = entry.peak_used_size;
+
+        const size_t max_alloc_size = heap->getMaxAllocatableSize(sizeof(void*));
+        stats.fragmentation = free_size == 0 ? 0.0f : 1.0f - f32(max_alloc_size) / f32(free_size);
+    }
+
+    snapshot->num_tags = 0;
+    for (s32 i = 0, n = sead::Mathi::min(sMemoryProfiler.num_tags, MaxTags); i < n; ++i) {
+        auto& entry = sMemoryProfiler.tags[i];
+        if (!entry.name)
+            continue;
+
+        auto& stats = snapshot->tags[snapshot->num_tags++];
+        stats.name = entry.name;
+        stats.num_allocs = entry.num_allocs;
+        stats.num_frees = entry.num_frees;
+        stats.allocated_size = entry.allocated_size;
+        stats.freed_size = entry.freed_size;
+    }
+}
+
+const MemoryProfiler::Snapshot& MemoryProfiler::getLatestSnapshot() const {
+    return sMemoryProfiler.snapshots[sMemoryProfiler.latest_snapshot_idx];
+}
+
+const MemoryProfiler::Snapshot& MemoryProfiler::getPreviousSnapshot() const {
+    return sMemoryProfiler.snapshots[sMemoryProfiler.latest_snapshot_idx ^ 1];
+}
+
+void MemoryProfiler::diffSnapshots(Snapshot* result, const Snapshot& from, const Snapshot& to) {
+    *result = to;
+    result->frame = to.frame - from.frame;
+
+    for (s32 i = 0; i < result->num_heaps; ++i) {
+        auto& stats = result->heaps[i];
+        for (s32 j = 0; j < from.num_heaps; ++j) {
+            const auto& old = from.heaps[j];
+            if (old.heap != stats.heap)
+                continue;
+            stats.num_allocs -= old.num_allocs;
+            stats.num_frees -= old.num_frees;
+            stats.allocated_size -= old.allocated_size;
+            stats.freed_size -= old.freed_size;
+            break;
+        }
+    }
+
+    for (s32 i = 0; i < result->num_tags; ++i) {
+        auto& stats = result->tags[i];
+        for (s32 j = 0; j < from.num_tags; ++j) {
+            const auto& old = from.tags[j];
+            if (old.name != stats.name)
+                continue;
+            stats.num_allocs -= old.num_allocs;
+            stats.num_frees -= old.num_frees;
+            stats.allocated_size -= old.allocated_size;
+            stats.freed_size -= old.freed_size;
+            break;
+        }
+    }
+}
+
+bool MemoryProfiler::writeCsv(const sead::SafeString& path, const Snapshot& snapshot) {
+    static constexpr const char* sHeapTypeNames[] = {"Generic", "DualHeap", "DualFrameHeap",
+                                                     "OverlayArena", "CompactedHeap"};
+
+    sead::FileHandle handle;
+    if (!sead::FileDeviceMgr::instance()->tryOpen(&handle, path,
+                                                   sead::FileDevice::cFileOpenFlag_WriteOnly)) {
+        return false;
+    }
+
+    const auto write = [&handle](const sead::SafeString& str) {
+        handle.write(reinterpret_cast<const u8*>(str.cstr()), u32(str.calcLength()));
+    };
+
+    write("kind,name,type,frame,allocs,frees,allocated,freed,size,used,peak,fragmentation\n");
+
+    for (s32 i = 0; i < snapshot.num_heaps; ++i) {
+        const auto& stats = snapshot.heaps[i];
+        write(sead::FormatFixedSafeString<256>(
+            "heap,%s,%s,%u,%u,%u,%llu,%llu,%zu,%zu,%zu,%.3f\n", stats.name.cstr(),
+            sHeapTypeNames[u8(stats.type)], snapshot.frame, stats.num_allocs, stats.num_frees,
+            stats.allocated_size, stats.freed_size, stats.size, stats.used_size,
+            stats.peak_used_size, stats.fragmentation));
+    }
+
+    for (s32 i = 0; i < snapshot.num_tags; ++i) {
+        const auto& stats = snapshot.tags[i];
+        write(sead::FormatFixedSafeString<256>("tag,%s,,%u,%u,%u,%llu,%llu,,,,\n", stats.name,
+                                               snapshot.frame, stats.num_allocs, stats.num_frees,
+                                               stats.allocated_size, stats.freed_size));
+    }
+
+    return true;
+}
+
 }  // namespace ksys
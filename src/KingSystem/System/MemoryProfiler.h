@@ -1,21 +1,129 @@
 #pragma once
 
+#include <basis/seadTypes.h>
 #include <heap/seadDisposer.h>
+#include <prim/seadSafeString.h>
 #include "KingSystem/Utils/Types.h"
 
 namespace ksys {
 
+/// Tracks allocation counters for a set of registered heaps.
+///
+/// sead heaps do not provide allocation hooks, so counters are recorded at the granularity at
+/// which the game carves up its big heaps: sub-heaps. trackSubHeap records the allocation of a
+/// sub-heap in its parent and attaches a disposer to the sub-heap, which records the matching
+/// free when the sub-heap is destroyed. Individual allocations can also be reported with
+/// recordAlloc and recordFree.
+///
+/// Allocations can be attributed to a subsystem with ScopedTag. Heap usage, high-water marks
+/// and free space fragmentation are sampled from the heaps themselves every few frames, so
+/// usage figures also cover allocations that are not counted.
+/// Consecutive snapshots can be diffed and dumped as CSV.
+///
+/// Recording is a few atomic operations per call, which is cheap enough for perf builds.
 class MemoryProfiler {
     SEAD_SINGLETON_DISPOSER(MemoryProfiler)
     MemoryProfiler() = default;
+    ~MemoryProfiler();
 
 public:
+    enum class HeapType : u8 {
+        Generic = 0,
+        DualHeap = 1,
+        DualFrameHeap = 2,
+        OverlayArena = 3,
+        CompactedHeap = 4,
+    };
+
+    static constexpr s32 MaxHeaps = 64;
+    static constexpr s32 MaxTags = 32;
+    static constexpr s32 MaxSubHeaps = 0x800;
+
+    struct HeapStats {
+        const sead::Heap* heap;
+        HeapType type;
+        sead::FixedSafeString<32> name;
+        u32 num_allocs;
+        u32 num_frees;
+        u64 allocated_size;
+        u64 freed_size;
+        size_t size;
+        size_t used_size;
+        size_t peak_used_size;
+        /// 0 means all free space is contiguous; 1 means no free space can be allocated.
+        f32 fragmentation;
+    };
+
+    struct TagStats {
+        const char* name;
+        u32 num_allocs;
+        u32 num_frees;
+        u64 allocated_size;
+        u64 freed_size;
+    };
+
+    struct Snapshot {
+        u32 frame;
+        s32 num_heaps;
+        HeapStats heaps[MaxHeaps];
+        s32 num_tags;
+        TagStats tags[MaxTags];
+    };
+
+    /// Attributes allocations that are recorded by the current thread to a tag.
+    /// Tags nest; the innermost one is used. Tags are identified by address, so `tag` should
+    /// be a string literal.
+    class ScopedTag {
+    public:
+        explicit ScopedTag(const char* tag);
+        ~ScopedTag();
+        ScopedTag(const ScopedTag&) = delete;
+        auto operator=(const ScopedTag&) = delete;
+
+    private:
+        s32 mPreviousTag = -1;
+    };
+
     void init(sead::Heap* heap);
 
+    bool trackHeap(const sead::Heap* heap, HeapType type);
+    void untrackHeap(const sead::Heap* heap);
+
+    void recordAlloc(const sead::Heap* heap, size_t size);
+    void recordFree(const sead::Heap* heap, size_t size);
+
+    /// Records the allocation of `child` in `parent`, and the matching free when `child` is
+    /// destroyed. Both are attributed to the tag that is active when this is called.
+    void trackSubHeap(const sead::Heap* parent, sead::Heap* child);
+
+    /// Takes a new snapshot every `interval` frames. Called once per frame.
+    void calc();
+    void setSnapshotInterval(u32 interval) { sSnapshotInterval = interval; }
+
+    /// Fills the specified snapshot with the current counters.
+    void takeSnapshot(Snapshot* snapshot) const;
+    const Snapshot& getLatestSnapshot() const;
+    const Snapshot& getPreviousSnapshot() const;
+
+    /// Computes `to - from`. Usage figures (size, used size, peak, fragmentation) are taken
+    /// from `to`; counters are differences.
+    static void diffSnapshots(Snapshot* result, const Snapshot& from, const Snapshot& to);
+    /// Writes one CSV row per heap and tag.
+    static bool writeCsv(const sead::SafeString& path, const Snapshot& snapshot);
+
     sead::Heap* mHeap{};
     void* _28{};
     void* _30{};
+
+private:
+    static u32 sSnapshotInterval;
 };
 KSYS_CHECK_SIZE_NX150(MemoryProfiler, 0x38);
 
+/// Convenience wrapper that does nothing if the MemoryProfiler has not been created.
+inline void trackSubHeap(const sead::Heap* parent, sead::Heap* child) {
+    if (auto* profiler = MemoryProfiler::instance())
+        profiler->trackSubHeap(parent, child);
+}
+
 }  // namespace ksys
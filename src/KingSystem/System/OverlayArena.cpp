@@ -3,6 +3,7 @@
 #include "KingSystem/Resource/resResourceMgrTask.h"
 #include "KingSystem/Resource/resSystem.h"
 #include "KingSystem/Resource/resUnit.h"
+#include "KingSystem/System/MemoryProfiler.h"
 #include "KingSystem/Utils/HeapUtil.h"
 
 namespace ksys {
@@ -13,6 +14,8 @@ OverlayArena::OverlayArena() {
 }
 
 OverlayArena::~OverlayArena() {
+    if (auto* profiler = MemoryProfiler::instance())
+        profiler->untrackHeap(mHeap);
     destroy();
 }
 
@@ -46,6 +49,9 @@ bool OverlayArena::init(const OverlayArena::InitArg& arg) {
     if (res::ResourceMgrTask::instance())
         res::ResourceMgrTask::instance()->insertOverlayArena(this);
 
+    if (auto* profiler = MemoryProfiler::instance())
+        profiler->trackHeap(mHeap, MemoryProfiler::HeapType::OverlayArena);
+
     mFlags.change(Flag::_20, arg.set_flag_20);
     mFlags.change(Flag::_10, arg.set_flag_10);
 
@@ -125,6 +131,95 @@ bool OverlayArena::checkIsOom() const {
     return false;
 }
 
+f32 OverlayArena::getFragmentation() const {
+    if (!mHeap)
+        return 0.0;
+
+    const size_t free_size = mHeap->getFreeSize();
+    if (free_size == 0)
+        return 0.0;
+
+    const size_t max_alloc_size = mHeap->getMaxAllocatableSize(res::getDefaultAlignment());
+    return 1.0f - f32(max_alloc_size) / f32(free_size);
+}
+
+size_t OverlayArena::calcMergedFreeSize_(const res::ResourceUnit& unit) const {
+    // Gaps that are smaller than this are block headers and alignment padding.
+    constexpr uintptr_t MinFreeBlockSize = 0x1000;
+
+    const sead::Heap* heap = unit.getHeap();
+    const auto start = uintptr_t(heap->getStartAddress());
+    const auto end = uintptr_t(heap->getEndAddress());
+
+    // Almost everything in an arena is a unit heap, so memory between this heap and the closest
+    // unit heaps around it is assumed to be free.
+    auto prev_end = uintptr_t(mHeap->getStartAddress());
+    auto next_start = uintptr_t(mHeap->getEndAddress());
+    for (const res::ResourceUnit& other : mUnits) {
+        const sead::Heap* other_heap = other.getHeap();
+        if (!other_heap || other_heap == heap)
+            continue;
+
+        const auto other_start = uintptr_t(other_heap->getStartAddress());
+        const auto other_end = uintptr_t(other_heap->getEndAddress());
+        if (other_end <= start)
+            prev_end = std::max(prev_end, other_end);
+        else if (other_start >= end)
+            next_start = std::min(next_start, other_start);
+    }
+
+    const uintptr_t gap_before = start - prev_end;
+    const uintptr_t gap_after = next_start - end;
+    if (gap_before < MinFreeBlockSize && gap_after < MinFreeBlockSize)
+        return 0;
+    return gap_before + (end - start) + gap_after;
+}
+
+u32 OverlayArena::evictUnits(u32 max_bytes, f32 min_fragmentation) {
+    if (!mHeap)
+        return 0;
+
+    const auto lock = sead::makeScopedLock(mCS);
+
+    // Memory from the previous step has not been freed yet: measuring now would overestimate
+    // the fragmentation and evict more than necessary.
+    for (const res::ResourceUnit& unit : mUnits) {
+        if (unit.isStatusFlag10000Set())
+            return 0;
+    }
+
+    // Clearing is asynchronous, so the effect of each eviction on the heap is estimated.
+    size_t free_size = mHeap->getFreeSize();
+    size_t max_block_size = mHeap->getMaxAllocatableSize(res::getDefaultAlignment());
+    const auto is_fragmented = [&] {
+        return free_size != 0 && 1.0f - f32(max_block_size) / f32(free_size) >= min_fragmentation;
+    };
+
+    u32 evicted_size = 0;
+    for (auto it = mUnits.robustBegin(), end = mUnits.robustEnd(); it != end; ++it) {
+        if (evicted_size >= max_bytes || !is_fragmented())
+            break;
+
+        res::ResourceUnit* unit = std::addressof(*it);
+        if (!unit->isEvictable())
+            continue;
+
+        // Evicting a unit that is surrounded by other units does not create a larger free block.
+        const size_t merged_size = calcMergedFreeSize_(*unit);
+        if (merged_size == 0)
+            continue;
+
+        const size_t unit_size = unit->getHeapSize();
+        if (!res::ResourceMgrTask::instance()->requestEvictUnit(unit))
+            continue;
+
+        evicted_size += unit_size;
+        free_size += unit_size;
+        max_block_size = std::max(max_block_size, merged_size);
+    }
+    return evicted_size;
+}
+
 // FIXME: figure out what sead function this is
 bool seadCheckPointer(void* ptr);
 
@@ -152,6 +247,8 @@ util::DualHeap* OverlayArena::makeDualHeap(u32 size, const sead::SafeString& nam
             return nullptr;
     }
 
+    trackSubHeap(mHeap, heap);
+
     if (unit && !seadCheckPointer(unit)) {
         mUnits.pushBack(unit);
         mFlags.set(Flag::_2);
@@ -61,6 +61,18 @@ public:
     /// @return whether the arena is running OOM.
     bool checkIsOom() const;
 
+    /// @return how fragmented the free space in this arena is, from 0 (a single free block)
+    ///         to 1 (no usable free block).
+    f32 getFragmentation() const;
+
+    /// Requests cached resource units that are no longer referenced and that border a free block
+    /// to be cleared, so that their memory coalesces with that block. Stops as soon as the arena
+    /// is expected to be less fragmented than min_fragmentation. Evicted resources are simply
+    /// loaded again the next time they are requested.
+    /// @param max_bytes  Maximum number of bytes to evict.
+    /// @return the number of bytes that were evicted.
+    u32 evictUnits(u32 max_bytes, f32 min_fragmentation);
+
     util::DualHeap* makeDualHeap(u32 size, const sead::SafeString& name,
                                  sead::Heap::HeapDirection direction, res::ResourceUnit* unit,
                                  bool x);
@@ -85,6 +97,9 @@ private:
     };
 
     void setBloodyMoonReasonForOom_() const;
+    /// @return the size of the free block that clearing the unit would create,
+    ///         or 0 if the unit does not border a free block.
+    size_t calcMergedFreeSize_(const res::ResourceUnit& unit) const;
 
     bool x_1(s32 size);
 
@@ -3,8 +3,10 @@
 #include <heap/seadExpHeap.h>
 #include <heap/seadHeap.h>
 #include <thread/seadThreadUtil.h>
+#include "KingSystem/Resource/resDefragmenter.h"
 #include "KingSystem/Resource/resSystem.h"
 #include "KingSystem/Sound/sndResource.h"
+#include "KingSystem/System/MemoryProfiler.h"
 #include "KingSystem/System/OverlayArena.h"
 #include "KingSystem/System/SystemPauseMgr.h"
 #include "KingSystem/Terrain/teraSystem.h"
@@ -68,6 +70,10 @@ void OverlayArenaSystem::destroyHeaps() {
 bool OverlayArenaSystem::init(const InitArg& arg, sead::Heap* heap) {
     mSystemPauseMgr = arg.system_pause_mgr;
 
+    // Created first so that the arena heaps are tracked as soon as they exist.
+    MemoryProfiler::createInstance(heap);
+    MemoryProfiler::instance()->init(heap);
+
     mPrepareThread = new (heap) util::TaskThread(
         "OverlayArena Prepare", heap, sead::ThreadUtil::ConvertPrioritySeadToPlatform(17),
         sead::MessageQueue::BlockType::Blocking, 0x7fffffff, 0x14000, 32);
@@ -118,6 +124,9 @@ bool OverlayArenaSystem::init(const InitArg& arg, sead::Heap* heap) {
     mS1.init();
     res::stubbedLogFunction();
 
+    res::Defragmenter::createInstance(heap);
+    res::Defragmenter::instance()->init({}, heap);
+
     if (mSystemPauseMgr) {
         res::stubbedLogFunction();
         mSystemPauseMgr->m2();
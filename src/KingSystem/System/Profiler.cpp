@@ -0,0 +1,290 @@
+#include "KingSystem/System/Profiler.h"
+
+#ifdef KSYS_PROFILER
+
+#include <algorithm>
+#include <codec/seadHashCRC32.h>
+#include <cstring>
+#include <filedevice/seadFileDeviceMgr.h>
+#include <heap/seadHeap.h>
+#include <limits>
+#include <mc/seadCoreInfo.h>
+#include <prim/seadSafeString.h>
+#include <prim/seadScopedLock.h>
+#include <thread/seadAtomic.h>
+#include <thread/seadCriticalSection.h>
+#include <thread/seadThread.h>
+#include <time/seadTickSpan.h>
+#include <time/seadTickTime.h>
+#include "KingSystem/Utils/Thread/ThreadSlot.h"
+
+namespace ksys {
+
+namespace {
+
+/// Single-producer single-consumer event ring. Only the owning thread writes events;
+/// only the thread that calls Profiler::onFrameEnd reads them.
+struct ThreadEventBuffer {
+    Profiler::Event* events;
+    u32 mask;
+    sead::Atomic<u32> write_idx;
+    sead::Atomic<u32> read_idx;
+    sead::Atomic<u32> num_dropped;
+    /// Only accessed by the reader.
+    s32 depth;
+    u64 outer_begin_tick;
+};
+
+struct ProfilerState {
+    sead::Heap* heap = nullptr;
+    u32 num_events_per_thread = 0;
+    ThreadEventBuffer buffers[Profiler::MaxThreads]{};
+
+    Profiler::Event* captured_events = nullptr;
+    u32 max_captured_events = 0;
+    u32 num_captured_events = 0;
+    sead::Atomic<bool> capturing = false;
+
+    u32 frame = 0;
+    Profiler::FrameStats last_frame_stats{};
+
+    /// Open addressing hash table of interned names. The size is a power of 2.
+    const char** interned_names = nullptr;
+    u32 interned_names_mask = 0;
+    u32 num_interned_names = 0;
+    char* name_pool = nullptr;
+    u32 name_pool_size = 0;
+    u32 name_pool_used = 0;
+    sead::CriticalSection names_cs;
+};
+
+ProfilerState sProfiler;
+
+/// Returned by internName once the name pool is full.
+constexpr const char* cOverflowName = "(too many names)";
+
+ThreadEventBuffer* getBufferForCurrentThread() {
+    const s32 slot = util::getCurrentThreadSlot();
+    if (slot < 0)
+        return nullptr;
+
+    auto& buffer = sProfiler.buffers[slot];
+    if (!buffer.events) {
+        // Only this thread can allocate its own buffer.
+        buffer.mask = sProfiler.num_events_per_thread - 1;
+        buffer.events =
+            new (sProfiler.heap, std::nothrow_t()) Profiler::Event[sProfiler.num_events_per_thread];
+    }
+    return buffer.events ? &buffer : nullptr;
+}
+
+void record(const char* name, Profiler::EventType type) {
+    if (!sProfiler.heap)
+        return;
+
+    ThreadEventBuffer* buffer = getBufferForCurrentThread();
+    if (!buffer)
+        return;
+
+    const u32 write_idx = buffer->write_idx;
+    if (write_idx - buffer->read_idx > buffer->mask) {
+        buffer->num_dropped.increment();
+        return;
+    }
+
+    auto& event = buffer->events[write_idx & buffer->mask];
+    event.tick = sead::TickTime().toTicks();
+    event.name = name;
+    event.type = type;
+    event.core_id = u8(int(sead::CoreInfo::getCurrentCoreId()));
+    event.thread_idx = u8(buffer - sProfiler.buffers);
+    event.frame = sProfiler.frame;
+    buffer->write_idx.increment();
+}
+
+/// Appends `str` to `out` as the contents of a JSON string.
+void appendJsonEscaped(sead::BufferedSafeString* out, const char* str) {
+    for (; *str; ++str) {
+        const char c = *str;
+        if (c == '"' || c == '\\')
+            out->appendWithFormat("\\%c", c);
+        else if (u8(c) < 0x20)
+            out->appendWithFormat("\\u%04x", u8(c));
+        else
+            out->append(c);
+    }
+}
+
+}  // namespace
+
+bool Profiler::init(const InitArg& arg, sead::Heap* heap) {
+    if (sProfiler.heap || !sead::Mathu::isPow2(arg.num_events_per_thread) ||
+        !sead::Mathu::isPow2(arg.max_interned_names)) {
+        return false;
+    }
+
+    sProfiler.num_events_per_thread = arg.num_events_per_thread;
+    sProfiler.max_captured_events = arg.num_captured_events;
+    sProfiler.captured_events = new (heap, std::nothrow_t()) Event[arg.num_captured_events];
+    sProfiler.interned_names = new (heap, std::nothrow_t()) const char*[arg.max_interned_names];
+    sProfiler.name_pool = new (heap, std::nothrow_t()) char[arg.name_pool_size];
+    if (!sProfiler.captured_events || !sProfiler.interned_names || !sProfiler.name_pool)
+        return false;
+
+    for (u32 i = 0; i < arg.max_interned_names; ++i)
+        sProfiler.interned_names[i] = nullptr;
+    sProfiler.interned_names_mask = arg.max_interned_names - 1;
+    sProfiler.name_pool_size = arg.name_pool_size;
+
+    sProfiler.heap = heap;
+    return true;
+}
+
+void Profiler::begin(const char* name) {
+    record(name, EventType::Begin);
+}
+
+void Profiler::end(const char* name) {
+    record(name, EventType::End);
+}
+
+const char* Profiler::internName(const sead::SafeString& name) {
+    if (!sProfiler.heap)
+        return cOverflowName;
+
+    const u32 hash = sead::HashCRC32::calcStringHash(name);
+    const auto lock = sead::makeScopedLock(sProfiler.names_cs);
+
+    const u32 mask = sProfiler.interned_names_mask;
+    for (u32 i = hash & mask;; i = (i + 1) & mask) {
+        const char* entry = sProfiler.interned_names[i];
+        if (entry) {
+            if (name == entry)
+                return entry;
+            continue;
+        }
+
+        // Keep the table at most half full so that probe sequences stay short.
+        const u32 size = u32(name.calcLength()) + 1;
+        if (2 * (sProfiler.num_interned_names + 1) > mask + 1 ||
+            sProfiler.name_pool_used + size > sProfiler.name_pool_size) {
+            return cOverflowName;
+        }
+
+        char* copy = sProfiler.name_pool + sProfiler.name_pool_used;
+        std::memcpy(copy, name.cstr(), size);
+        sProfiler.name_pool_used += size;
+        sProfiler.interned_names[i] = copy;
+        ++sProfiler.num_interned_names;
+        return copy;
+    }
+}
+
+void Profiler::onFrameEnd() {
+    auto& stats = sProfiler.last_frame_stats;
+    stats = {};
+    stats.frame = sProfiler.frame;
+
+    const bool capturing = sProfiler.capturing;
+    const s32 num_buffers = util::getNumThreadSlots();
+    for (s32 i = 0; i < num_buffers; ++i) {
+        auto& buffer = sProfiler.buffers[i];
+        if (!buffer.events)
+            continue;
+
+        const u32 write_idx = buffer.write_idx;
+        for (u32 idx = buffer.read_idx; idx != write_idx; ++idx) {
+            const Event& event = buffer.events[idx & buffer.mask];
+
+            if (event.type == EventType::Begin) {
+                if (buffer.depth++ == 0)
+                    buffer.outer_begin_tick = event.tick;
+            } else if (buffer.depth > 0 && --buffer.depth == 0) {
+                stats.busy_ticks[i] += event.tick - buffer.outer_begin_tick;
+            }
+
+            if (capturing && sProfiler.num_captured_events < sProfiler.max_captured_events)
+                sProfiler.captured_events[sProfiler.num_captured_events++] = event;
+        }
+
+        stats.num_events += write_idx - buffer.read_idx;
+        stats.num_dropped_events += buffer.num_dropped.exchange(0);
+        buffer.read_idx = write_idx;
+    }
+
+    ++sProfiler.frame;
+}
+
+const Profiler::FrameStats& Profiler::getLastFrameStats() {
+    return sProfiler.last_frame_stats;
+}
+
+void Profiler::startCapture() {
+    sProfiler.num_captured_events = 0;
+    sProfiler.capturing = true;
+}
+
+void Profiler::stopCapture() {
+    sProfiler.capturing = false;
+}
+
+bool Profiler::isCapturing() {
+    return sProfiler.capturing;
+}
+
+u32 Profiler::getNumCapturedEvents() {
+    return sProfiler.num_captured_events;
+}
+
+bool Profiler::writeChromeTrace(const sead::SafeString& path) {
+    sead::FileHandle handle;
+    if (!sead::FileDeviceMgr::instance()->tryOpen(&handle, path,
+                                                   sead::FileDevice::cFileOpenFlag_WriteOnly)) {
+        return false;
+    }
+
+    const auto write = [&handle](const sead::SafeString& str) {
+        handle.write(reinterpret_cast<const u8*>(str.cstr()), u32(str.calcLength()));
+    };
+
+    write("{\"traceEvents\":[\n");
+
+    bool first = true;
+    const s32 num_buffers = util::getNumThreadSlots();
+    for (s32 i = 0; i < num_buffers; ++i) {
+        const sead::Thread* thread = util::getThreadForSlot(i);
+        if (!thread || !sProfiler.buffers[i].events)
+            continue;
+        sead::FixedSafeString<64> name;
+        appendJsonEscaped(&name, thread->getName().cstr());
+        write(sead::FormatFixedSafeString<128>(
+            "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":%d,"
+            "\"args\":{\"name\":\"%s\"}}",
+            first ? "" : ",\n", i, name.cstr()));
+        first = false;
+    }
+
+    u64 base_tick = std::numeric_limits<u64>::max();
+    for (u32 i = 0; i < sProfiler.num_captured_events; ++i)
+        base_tick = std::min(base_tick, sProfiler.captured_events[i].tick);
+
+    for (u32 i = 0; i < sProfiler.num_captured_events; ++i) {
+        const Event& event = sProfiler.captured_events[i];
+        const s64 ts = sead::TickSpan(s64(event.tick - base_tick)).toMicroSeconds();
+        sead::FixedSafeString<256> name;
+        appendJsonEscaped(&name, event.name);
+        write(sead::FormatFixedSafeString<512>(
+            "%s{\"name\":\"%s\",\"ph\":\"%c\",\"ts\":%lld,\"pid\":0,\"tid\":%u,"
+            "\"args\":{\"core\":%u,\"frame\":%u}}",
+            first ? "" : ",\n", name.cstr(), event.type == EventType::Begin ? 'B' : 'E', ts,
+            event.thread_idx, event.core_id, event.frame));
+        first = false;
+    }
+
+    write("\n]}\n");
+    return true;
+}
+
+}  // namespace ksys
+
+#endif
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <basis/seadTypes.h>
+#include <prim/seadSafeString.h>
+#include "KingSystem/Utils/Thread/ThreadSlot.h"
+#include "KingSystem/Utils/Types.h"
+
+namespace sead {
+class Heap;
+}
+
+namespace ksys {
+
+/// Hierarchical scope profiler.
+///
+/// Scopes are recorded as begin/end events into per-thread ring buffers without taking any lock.
+/// The buffers are drained once per frame by calling onFrameEnd(), which aggregates per-thread
+/// busy times for the frame and optionally appends the events to a capture buffer that can be
+/// exported in the Chrome trace event format (chrome://tracing, Perfetto).
+///
+/// Unless KSYS_PROFILER is defined, every recording function is an empty inline function and
+/// KSYS_PROFILE_SCOPE expands to nothing.
+class Profiler {
+public:
+    static constexpr s32 MaxThreads = util::MaxThreadSlots;
+
+    enum class EventType : u8 {
+        Begin = 0,
+        End = 1,
+    };
+
+    struct Event {
+        u64 tick;
+        const char* name;
+        EventType type;
+        u8 core_id;
+        u8 thread_idx;
+        u32 frame;
+    };
+    KSYS_CHECK_SIZE_NX150(Event, 0x18);
+
+    struct InitArg {
+        /// Must be a power of 2.
+        u32 num_events_per_thread = 0x1000;
+        u32 num_captured_events = 0x20000;
+        /// Storage for names that are passed to internName.
+        u32 name_pool_size = 0x40000;
+        /// Must be a power of 2.
+        u32 max_interned_names = 0x2000;
+    };
+
+    struct FrameStats {
+        u32 frame;
+        u32 num_events;
+        u32 num_dropped_events;
+        /// Time spent inside outermost scopes during the frame, for each thread slot.
+        u64 busy_ticks[MaxThreads];
+    };
+
+    class Scope {
+    public:
+        explicit Scope(const char* name) : mName(name) { begin(name); }
+        ~Scope() { end(mName); }
+        Scope(const Scope&) = delete;
+        auto operator=(const Scope&) = delete;
+
+    private:
+        const char* mName;
+    };
+
+#ifdef KSYS_PROFILER
+    static bool init(const InitArg& arg, sead::Heap* heap);
+
+    /// `name` is stored as is and must stay valid until the capture has been written.
+    /// Names that are not string literals must be interned first.
+    static void begin(const char* name);
+    static void end(const char* name);
+
+    /// @return a copy of the specified name that is owned by the profiler and stays valid until
+    ///         the program exits. Equal names return the same pointer.
+    static const char* internName(const sead::SafeString& name);
+
+    /// Drains all per-thread buffers. Must be called from a single thread (usually the main
+    /// thread) once per frame.
+    static void onFrameEnd();
+    static const FrameStats& getLastFrameStats();
+
+    static void startCapture();
+    static void stopCapture();
+    static bool isCapturing();
+    static u32 getNumCapturedEvents();
+
+    /// Writes all captured events to the specified file as Chrome trace JSON.
+    static bool writeChromeTrace(const sead::SafeString& path);
+#else
+    static bool init(const InitArg&, sead::Heap*) { return true; }
+
+    static void begin(const char*) {}
+    static void end(const char*) {}
+
+    static const char* internName(const sead::SafeString&) { return ""; }
+
+    static void onFrameEnd() {}
+
+    static void startCapture() {}
+    static void stopCapture() {}
+    static bool isCapturing() { return false; }
+    static u32 getNumCapturedEvents() { return 0; }
+
+    static bool writeChromeTrace(const sead::SafeString&) { return false; }
+#endif
+};
+
+}  // namespace ksys
+
+#ifdef KSYS_PROFILER
+#define KSYS_PROFILE_SCOPE_CAT_(A, B) A##B
+#define KSYS_PROFILE_SCOPE_CAT(A, B) KSYS_PROFILE_SCOPE_CAT_(A, B)
+#define KSYS_PROFILE_SCOPE(NAME)                                                                   \
+    const ksys::Profiler::Scope KSYS_PROFILE_SCOPE_CAT(ksys_profile_scope_, __LINE__)(NAME)
+/// Same as KSYS_PROFILE_SCOPE, for names that may not outlive the scope (e.g. resource paths).
+#define KSYS_PROFILE_SCOPE_DYNAMIC(NAME) KSYS_PROFILE_SCOPE(ksys::Profiler::internName(NAME))
+#else
+#define KSYS_PROFILE_SCOPE(NAME) static_cast<void>(0)
+#define KSYS_PROFILE_SCOPE_DYNAMIC(NAME) static_cast<void>(0)
+#endif
@@ -1,5 +1,10 @@
 #include "KingSystem/System/VFR.h"
 #include <mc/seadCoreInfo.h>
+#include <time/seadTickSpan.h>
+#include "KingSystem/System/MemoryProfiler.h"
+#include "KingSystem/System/Profiler.h"
+#include "KingSystem/System/VFRController.h"
+#include "KingSystem/Utils/Thread/ThreadSlot.h"
 
 namespace ksys {
 
@@ -78,6 +83,12 @@ void VFR::init(u32 interval, int num_speed_multipliers, sead::Heap* heap, u32 ma
     mMask = mask;
     setMinDelta();
     copyAtoB();
+
+    // Profiler buffers are drained at the start of every frame by updateInterval.
+    Profiler::init({}, heap);
+
+    VFRController::createInstance(heap);
+    VFRController::instance()->init({});
 }
 
 void VFR::setIntervalOverride(u32 interval) {
@@ -115,9 +126,43 @@ void VFR::TimeSpeedMultiplier::update(f32 multiplier) {
     }
 }
 
+#ifdef KSYS_PROFILER
+static VFRController::FrameCost getLastFrameCost() {
+    const auto& stats = Profiler::getLastFrameStats();
+    const auto to_ms = [](u64 ticks) {
+        return f32(sead::TickSpan(s64(ticks)).toMicroSeconds()) / 1000.0f;
+    };
+
+    // updateInterval runs on the game thread. Resource and loading threads are instrumented too,
+    // but their work does not delay the frame, so only marked job threads are looked at.
+    const s32 game_slot = util::getCurrentThreadSlot();
+    VFRController::FrameCost cost{};
+    for (s32 i = 0; i < util::getNumThreadSlots(); ++i) {
+        const f32 busy_ms = to_ms(stats.busy_ticks[i]);
+        if (i == game_slot)
+            cost.game_ms = busy_ms;
+        else if (util::isJobThreadSlot(i))
+            cost.job_ms = sead::Mathf::max(cost.job_ms, busy_ms);
+    }
+    return cost;
+}
+#endif
+
 void VFR::updateInterval(u32 new_interval) {
+    // This is called once at the start of every frame.
+    Profiler::onFrameEnd();
+#ifdef KSYS_PROFILER
+    if (auto* controller = VFRController::instance())
+        controller->reportFrameCost(getLastFrameCost());
+#endif
+    if (auto* memory_profiler = MemoryProfiler::instance())
+        memory_profiler->calc();
+
     copyAtoB();
 
+    if (auto* controller = VFRController::instance())
+        new_interval = controller->calc(new_interval);
+
     if (mHasIntervalOverride)
         new_interval = mIntervalOverride;
 
@@ -0,0 +1,156 @@
+#include "KingSystem/System/VFRController.h"
+#include <algorithm>
+#include <cmath>
+#include <math/seadMathCalcCommon.h>
+
+namespace ksys {
+
+SEAD_SINGLETON_DISPOSER_IMPL(VFRController)
+
+VFRController::VFRController() = default;
+
+VFRController::~VFRController() {
+    mRecording.freeBuffer();
+}
+
+void VFRController::Governor::reset(const InitArg& new_arg) {
+    arg = new_arg;
+    arg.min_interval = sead::Mathu::max(arg.min_interval, 1);
+    arg.max_interval = sead::Mathu::max(arg.max_interval, arg.min_interval);
+    interval = arg.min_interval;
+    average_cost_ms = 0.0;
+    num_slow_frames = 0;
+    num_fast_frames = 0;
+    has_sample = false;
+}
+
+f32 VFRController::Governor::getBudget(u32 num_vsyncs) const {
+    return f32(num_vsyncs) * VsyncPeriodMs * arg.budget_ratio;
+}
+
+u32 VFRController::Governor::update(f32 cost_ms) {
+    if (has_sample)
+        average_cost_ms += arg.smoothing * (cost_ms - average_cost_ms);
+    else
+        average_cost_ms = cost_ms;
+    has_sample = true;
+
+    const bool is_slow = interval < arg.max_interval && average_cost_ms > getBudget(interval);
+    const bool is_fast = interval > arg.min_interval &&
+                         average_cost_ms < getBudget(interval - 1) * arg.speed_up_ratio;
+
+    num_slow_frames = is_slow ? num_slow_frames + 1 : 0;
+    num_fast_frames = is_fast ? num_fast_frames + 1 : 0;
+
+    if (num_slow_frames >= arg.frames_to_slow_down) {
+        ++interval;
+        num_slow_frames = 0;
+    } else if (num_fast_frames >= arg.frames_to_speed_up) {
+        --interval;
+        num_fast_frames = 0;
+    }
+
+    return interval;
+}
+
+void VFRController::init(const InitArg& arg) {
+    mGovernor.reset(arg);
+    mHasNewCost = false;
+}
+
+void VFRController::reportFrameCost(const FrameCost& cost) {
+    mLastCost = cost;
+    mHasNewCost = true;
+}
+
+u32 VFRController::calc(u32 requested_interval) {
+    u32 interval = requested_interval;
+
+    if (mReplayData) {
+        if (mReplayPos < mReplaySize)
+            interval = mReplayData[mReplayPos++];
+        else
+            stopReplay();
+    } else if (mEnabled && mHasNewCost) {
+        mHasNewCost = false;
+        // Keep the average up to date even when the caller does not want the interval changed.
+        const u32 chosen = mGovernor.update(sead::Mathf::max(mLastCost.game_ms, mLastCost.job_ms));
+        if (requested_interval != 0)
+            interval = sead::Mathu::max(interval, chosen);
+    }
+
+    if (mIsRecording) {
+        if (mNumRecordedFrames < u32(mRecording.size()))
+            mRecording[mNumRecordedFrames++] = u8(interval);
+        else
+            mIsRecording = false;
+    }
+
+    return interval;
+}
+
+bool VFRController::startRecording(u32 max_frames, sead::Heap* heap) {
+    if (u32(mRecording.size()) < max_frames) {
+        mRecording.freeBuffer();
+        if (!mRecording.tryAllocBuffer(s32(max_frames), heap))
+            return false;
+    }
+    mNumRecordedFrames = 0;
+    mIsRecording = true;
+    return true;
+}
+
+void VFRController::stopRecording() {
+    mIsRecording = false;
+}
+
+void VFRController::startReplay(const u8* intervals, u32 num_frames) {
+    mReplayData = intervals;
+    mReplaySize = num_frames;
+    mReplayPos = 0;
+}
+
+void VFRController::stopReplay() {
+    mReplayData = nullptr;
+    mReplaySize = 0;
+    mReplayPos = 0;
+}
+
+void VFRController::simulate(const InitArg& arg, const FrameCost* trace, u32 num_frames,
+                             SimulationResult* result) {
+    *result = {};
+    result->num_frames = num_frames;
+    if (num_frames == 0)
+        return;
+
+    Governor governor;
+    governor.reset(arg);
+
+    f64 sum = 0.0;
+    f64 sum_sq = 0.0;
+    u32 interval = governor.interval;
+    for (u32 i = 0; i < num_frames; ++i) {
+        const f32 cost = sead::Mathf::max(trace[i].game_ms, trace[i].job_ms);
+
+        // A frame is shown on the first vsync that is both after the target interval
+        // and after the frame is done.
+        const u32 num_vsyncs_needed = u32(std::ceil(cost / VsyncPeriodMs));
+        if (num_vsyncs_needed > interval)
+            ++result->num_missed_vsyncs;
+        const f64 frame_time = sead::Mathu::max(interval, num_vsyncs_needed) * VsyncPeriodMs;
+        sum += frame_time;
+        sum_sq += frame_time * frame_time;
+
+        const u32 next_interval = governor.update(cost);
+        if (next_interval != interval)
+            ++result->num_interval_changes;
+        interval = next_interval;
+    }
+
+    const f64 mean = sum / num_frames;
+    const f64 variance = std::max(sum_sq / num_frames - mean * mean, 0.0);
+    result->mean_frame_time_ms = f32(mean);
+    result->jitter_ms = f32(std::sqrt(variance));
+}
+
+}  // namespace ksys
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <basis/seadTypes.h>
+#include <container/seadBuffer.h>
+#include <heap/seadDisposer.h>
+#include "KingSystem/Utils/Types.h"
+
+namespace ksys {
+
+/// Picks the VFR present interval based on how expensive frames actually are.
+///
+/// VFR reports the cost of every frame (time spent on the game thread and on job threads), which
+/// is taken from the busy times that Profiler aggregates, so frame costs are only available in
+/// builds with KSYS_PROFILER. The controller keeps a moving average of that cost and switches
+/// to a longer interval when frames consistently exceed the frame-time budget, and back to a
+/// shorter interval once there is enough headroom. Two separate thresholds and minimum durations
+/// provide hysteresis so that the interval does not oscillate. Per-core delta frames are
+/// rescaled by VFR itself when the interval changes.
+///
+/// For deterministic replays, the chosen interval can be recorded for every frame and played
+/// back later; delta frames are a function of the interval and time multipliers.
+class VFRController {
+    SEAD_SINGLETON_DISPOSER(VFRController)
+    VFRController();
+    virtual ~VFRController();
+
+public:
+    struct InitArg {
+        u32 min_interval = 1;
+        u32 max_interval = 2;
+        /// Fraction of the interval duration that frames may take before they count as too slow.
+        f32 budget_ratio = 0.9;
+        /// A shorter interval is only picked if frames fit in this fraction of its budget.
+        f32 speed_up_ratio = 0.75;
+        /// Number of consecutive slow frames before the interval is increased.
+        u32 frames_to_slow_down = 4;
+        /// Number of consecutive fast frames before the interval is decreased.
+        u32 frames_to_speed_up = 60;
+        /// Weight of the latest frame in the moving average.
+        f32 smoothing = 0.2;
+    };
+
+    struct FrameCost {
+        f32 game_ms;
+        f32 job_ms;
+    };
+
+    struct SimulationResult {
+        u32 num_frames;
+        /// Number of frames that could not be presented on their target vsync.
+        u32 num_missed_vsyncs;
+        u32 num_interval_changes;
+        f32 mean_frame_time_ms;
+        /// Standard deviation of the presented frame times.
+        f32 jitter_ms;
+    };
+
+    static constexpr f32 VsyncPeriodMs = 1000.0f / 60.0f;
+
+    void init(const InitArg& arg);
+
+    bool isEnabled() const { return mEnabled; }
+    void setEnabled(bool enabled) { mEnabled = enabled; }
+
+    /// Reports the cost of the frame that has just been processed.
+    void reportFrameCost(const FrameCost& cost);
+
+    /// Picks the interval for the next frame. `requested_interval` is the interval that the game
+    /// asked for and acts as a lower bound. 0 means that the interval must not change and is
+    /// always returned as is (except during replays). Called by VFR once at the start of every
+    /// frame.
+    u32 calc(u32 requested_interval);
+
+    u32 getInterval() const { return mGovernor.interval; }
+    f32 getAverageFrameCost() const { return mGovernor.average_cost_ms; }
+    /// @return the time that a frame may take at the current interval, in milliseconds.
+    f32 getFrameTimeBudget() const { return mGovernor.getBudget(mGovernor.interval); }
+
+    bool startRecording(u32 max_frames, sead::Heap* heap);
+    void stopRecording();
+    bool isRecording() const { return mIsRecording; }
+    const u8* getRecordedIntervals() const { return mRecording.getBufferPtr(); }
+    u32 getNumRecordedFrames() const { return mNumRecordedFrames; }
+
+    /// Replays intervals that were recorded with startRecording. Frame costs are ignored
+    /// until the end of the recording is reached.
+    void startReplay(const u8* intervals, u32 num_frames);
+    void stopReplay();
+    bool isReplaying() const { return mReplayData != nullptr; }
+
+    /// Runs the controller over a synthetic frame cost trace and reports the resulting frame
+    /// pacing, assuming that frames are presented on the first vsync after they are done.
+    static void simulate(const InitArg& arg, const FrameCost* trace, u32 num_frames,
+                         SimulationResult* result);
+
+private:
+    struct Governor {
+        void reset(const InitArg& new_arg);
+        f32 getBudget(u32 num_vsyncs) const;
+        u32 update(f32 cost_ms);
+
+        InitArg arg;
+        u32 interval = 1;
+        f32 average_cost_ms = 0.0;
+        u32 num_slow_frames = 0;
+        u32 num_fast_frames = 0;
+        bool has_sample = false;
+    };
+
+    Governor mGovernor;
+    bool mEnabled = true;
+    bool mHasNewCost = false;
+    FrameCost mLastCost{};
+
+    sead::Buffer<u8> mRecording;
+    u32 mNumRecordedFrames = 0;
+    bool mIsRecording = false;
+
+    const u8* mReplayData = nullptr;
+    u32 mReplaySize = 0;
+    u32 mReplayPos = 0;
+};
+
+}  // namespace ksys
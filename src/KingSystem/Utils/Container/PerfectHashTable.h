@@ -0,0 +1,134 @@
+#pragma once
+
+#include <algorithm>
+#include <basis/seadTypes.h>
+
+namespace ksys::util {
+
+/// Minimal perfect hash over a fixed set of 32-bit keys (typically name hashes).
+///
+/// Keys are split into small buckets; each bucket stores a seed that maps all of its keys to
+/// distinct free slots (hash and displace). Lookups are two array reads and never branch on
+/// the key. Since every slot is used, find() returns an index for any key: callers must
+/// compare the stored key at that index to reject keys that are not part of the set.
+template <s32 MaxKeys>
+class PerfectHashTable {
+public:
+    static_assert(MaxKeys > 0 && MaxKeys < 0xffff, "indices must fit in a u16");
+
+    static constexpr s32 KeysPerBucket = 4;
+    static constexpr s32 MaxBuckets = (MaxKeys + KeysPerBucket - 1) / KeysPerBucket;
+
+    /// Builds the table for keys [0, num_keys). `get_key(i)` must return the key for index i.
+    /// Keys must be unique.
+    /// @return false if the keys do not fit or no seed could be found, in which case the table
+    ///         is left invalid and callers should fall back to a regular search.
+    template <typename GetKey>
+    bool build(s32 num_keys, const GetKey& get_key);
+
+    void clear() { mNumKeys = 0; }
+    bool isValid() const { return mNumKeys != 0; }
+    s32 getNumKeys() const { return mNumKeys; }
+
+    /// @return the only index that `key` can be stored at. Only meaningful if isValid().
+    s32 find(u32 key) const {
+        const u32 bucket = reduce(key, mNumBuckets);
+        return mSlots[reduce(mix(key, mSeeds[bucket]), mNumKeys)];
+    }
+
+private:
+    static constexpr u16 FreeSlot = 0xffff;
+
+    /// Maps a hash to [0, n) without a division.
+    static u32 reduce(u32 hash, u32 n) { return u32((u64(hash) * n) >> 32); }
+
+    static u32 mix(u32 key, u32 seed) {
+        u32 h = key ^ (seed * 0x9e3779b9u);
+        h ^= h >> 16;
+        h *= 0x85ebca6bu;
+        h ^= h >> 13;
+        h *= 0xc2b2ae35u;
+        h ^= h >> 16;
+        return h;
+    }
+
+    u32 mNumKeys = 0;
+    u32 mNumBuckets = 0;
+    u16 mSeeds[MaxBuckets]{};
+    u16 mSlots[MaxKeys]{};
+};
+
+template <s32 MaxKeys>
+template <typename GetKey>
+inline bool PerfectHashTable<MaxKeys>::build(s32 num_keys, const GetKey& get_key) {
+    mNumKeys = 0;
+    if (num_keys <= 0 || num_keys > MaxKeys)
+        return false;
+
+    const u32 num_buckets = u32(num_keys + KeysPerBucket - 1) / KeysPerBucket;
+
+    // Group key indices by bucket (counting sort).
+    u16 bucket_start[MaxBuckets + 1]{};
+    u16 bucket_keys[MaxKeys];
+    for (s32 i = 0; i < num_keys; ++i)
+        ++bucket_start[reduce(get_key(i), num_buckets) + 1];
+    for (u32 b = 0; b < num_buckets; ++b)
+        bucket_start[b + 1] += bucket_start[b];
+    {
+        u16 fill[MaxBuckets];
+        std::copy(bucket_start, bucket_start + num_buckets, fill);
+        for (s32 i = 0; i < num_keys; ++i)
+            bucket_keys[fill[reduce(get_key(i), num_buckets)]++] = u16(i);
+    }
+
+    // Place the largest buckets first while most slots are still free.
+    u16 order[MaxBuckets];
+    for (u32 b = 0; b < num_buckets; ++b)
+        order[b] = u16(b);
+    std::stable_sort(order, order + num_buckets, [&](u16 lhs, u16 rhs) {
+        return bucket_start[lhs + 1] - bucket_start[lhs] >
+               bucket_start[rhs + 1] - bucket_start[rhs];
+    });
+
+    std::fill(mSlots, mSlots + num_keys, FreeSlot);
+
+    for (u32 i = 0; i < num_buckets; ++i) {
+        const u32 bucket = order[i];
+        const u32 begin = bucket_start[bucket];
+        const u32 end = bucket_start[bucket + 1];
+        if (begin == end) {
+            mSeeds[bucket] = 0;
+            continue;
+        }
+
+        bool placed = false;
+        for (u32 seed = 0; seed <= 0xffff; ++seed) {
+            u32 j = begin;
+            for (; j < end; ++j) {
+                const u32 slot = reduce(mix(get_key(bucket_keys[j]), seed), u32(num_keys));
+                if (mSlots[slot] != FreeSlot)
+                    break;
+                mSlots[slot] = bucket_keys[j];
+            }
+
+            if (j == end) {
+                mSeeds[bucket] = u16(seed);
+                placed = true;
+                break;
+            }
+
+            // Undo the partial placement and try the next seed.
+            for (u32 k = begin; k < j; ++k)
+                mSlots[reduce(mix(get_key(bucket_keys[k]), seed), u32(num_keys))] = FreeSlot;
+        }
+
+        if (!placed)
+            return false;
+    }
+
+    mNumBuckets = num_buckets;
+    mNumKeys = u32(num_keys);
+    return true;
+}
+
+}  // namespace ksys::util
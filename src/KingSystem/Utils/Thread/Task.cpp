@@ -1,5 +1,6 @@
 #include "KingSystem/Utils/Thread/Task.h"
 #include <thread/seadThread.h>
+#include "KingSystem/System/Profiler.h"
 #include "KingSystem/Utils/Thread/TaskQueueBase.h"
 #include "KingSystem/Utils/Thread/TaskQueueLock.h"
 #include "KingSystem/Utils/Thread/TaskThread.h"
@@ -210,6 +211,7 @@ void Task::setThread(TaskThread* thread) {
 }
 
 void Task::run() {
+    KSYS_PROFILE_SCOPE_DYNAMIC(mName);
     run_();
     mStatus = Status::RunFinished;
 }
@@ -0,0 +1,72 @@
+#include "KingSystem/Utils/Thread/ThreadSlot.h"
+#include <math/seadMathCalcCommon.h>
+#include <thread/seadAtomic.h>
+#include <thread/seadThread.h>
+
+namespace ksys::util {
+
+namespace {
+sead::Atomic<const sead::Thread*> sThreadSlots[MaxThreadSlots]{};
+sead::Atomic<s32> sNumThreadSlots = 0;
+sead::Atomic<const sead::Thread*> sJobThreads[MaxThreadSlots]{};
+sead::Atomic<s32> sNumJobThreads = 0;
+
+bool isJobThread(const sead::Thread* thread) {
+    const s32 num_threads = sead::Mathi::min(sNumJobThreads, MaxThreadSlots);
+    for (s32 i = 0; i < num_threads; ++i) {
+        if (sJobThreads[i] == thread)
+            return true;
+    }
+    return false;
+}
+}  // namespace
+
+s32 getCurrentThreadSlot() {
+    const sead::Thread* thread = sead::ThreadMgr::instance()->getCurrentThread();
+
+    const s32 num_slots = getNumThreadSlots();
+    for (s32 i = 0; i < num_slots; ++i) {
+        if (sThreadSlots[i] == thread)
+            return i;
+    }
+
+    if (num_slots >= MaxThreadSlots)
+        return -1;
+
+    // A thread cannot race with itself, so the slot cannot be claimed twice for one thread.
+    const s32 slot = sNumThreadSlots.increment();
+    if (slot >= MaxThreadSlots)
+        return -1;
+
+    sThreadSlots[slot].store(thread);
+    return slot;
+}
+
+s32 getNumThreadSlots() {
+    return sead::Mathi::min(sNumThreadSlots, MaxThreadSlots);
+}
+
+const sead::Thread* getThreadForSlot(s32 slot) {
+    if (slot < 0 || slot >= MaxThreadSlots)
+        return nullptr;
+    return sThreadSlots[slot];
+}
+
+void markJobThread(const sead::Thread* thread) {
+    // Two threads marking the same thread at once may both add it; duplicates are harmless.
+    if (!thread || isJobThread(thread))
+        return;
+
+    const s32 idx = sNumJobThreads.increment();
+    if (idx >= MaxThreadSlots)
+        return;
+
+    sJobThreads[idx].store(thread);
+}
+
+bool isJobThreadSlot(s32 slot) {
+    const sead::Thread* thread = getThreadForSlot(slot);
+    return thread && isJobThread(thread);
+}
+
+}  // namespace ksys::util
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <basis/seadTypes.h>
+
+namespace sead {
+class Thread;
+}
+
+namespace ksys::util {
+
+constexpr s32 MaxThreadSlots = 32;
+
+/// Returns a small index that uniquely identifies the calling thread, which is convenient
+/// for indexing per-thread arrays. A slot is assigned on the first call from a thread and is
+/// never reused. This does not take any lock.
+/// @return a slot in [0, MaxThreadSlots) or -1 if all slots have already been assigned.
+s32 getCurrentThreadSlot();
+
+/// @return the number of slots that have been assigned so far.
+s32 getNumThreadSlots();
+
+/// @return the thread that was assigned the specified slot, or nullptr.
+const sead::Thread* getThreadForSlot(s32 slot);
+
+/// Marks a thread as a job thread, i.e. a thread that runs part of the frame's work on behalf of
+/// the game thread (actor jobs, worker support tasks), as opposed to background threads such as
+/// resource loaders. Marking a thread that is already marked does nothing.
+void markJobThread(const sead::Thread* thread);
+
+/// @return whether the thread that was assigned the specified slot is a job thread.
+bool isJobThreadSlot(s32 slot);
+
+}  // namespace ksys::util
@@ -11,6 +11,7 @@
 #include "KingSystem/Resource/resLoadRequest.h"
 #include "KingSystem/Resource/resResource.h"
 #include "KingSystem/System/CameraMgr.h"
+#include "KingSystem/System/Profiler.h"
 #include "KingSystem/Utils/InitTimeInfo.h"
 
 namespace ksys::world {
@@ -739,6 +740,7 @@ int Manager::getWeatherStormRate(Climate climate) const {
 }
 
 void Manager::calcManagers(sead::WorkerMgr* worker_mgr) {
+    KSYS_PROFILE_SCOPE("world::Manager::calcManagers");
     if (_5e0.isOffBit(0))
         worker_mgr = nullptr;
 
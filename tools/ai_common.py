@@ -53,6 +53,34 @@ def get_ai_vtable_names() -> Dict[int, str]:
     return names
 
 
+def get_static_param_names(info: list) -> List[str]:
+    """Returns the unique static parameter names of a class, in the order they are loaded."""
+    names = []
+    for entry in info:
+        if entry["type"] == "static_param" and entry["param_name"] and entry["param_name"] not in names:
+            names.append(entry["param_name"])
+    return names
+
+
+def generate_static_param_slots(def_type: str, class_name: str, names: List[str]) -> str:
+    """Generates a per-class table of pre-hashed static parameter keys.
+
+    class_name must be the name of the class in AIDef (which is what AIProgram definitions use)
+    so that the table can be resolved when AI programs are parsed.
+    """
+    if not names:
+        return ""
+
+    out = ["static ksys::act::ai::StaticParamSlot sStaticParams[] = {"]
+    for name in names:
+        out.append(f'    ksys::act::ai::StaticParamSlot{{"{name}"}},')
+    out.append("};")
+    out.append(f"static ksys::act::ai::StaticParamSlotTable sStaticParamTable{{ksys::AIDefType::{def_type}, "
+               f'"{class_name}", sStaticParams}};')
+    out.append("")
+    return "\n".join(out)
+
+
 def topologically_sort_vtables(all_vtables: dict, type_: str) -> List[int]:
     graph = Graph()
     for name, vtables in all_vtables[type_].items():
@@ -28,6 +28,7 @@ def get_member_name(entry) -> str:
 
 
 def generate_ai_loadparam_body(info: list) -> str:
+    static_param_names = ai_common.get_static_param_names(info)
     out = []
     for entry in info:
         type_ = entry["type"]
@@ -39,7 +40,8 @@ def generate_ai_loadparam_body(info: list) -> str:
                 out.append(f'getDynamicParam2(&{get_member_name(entry)}, "{entry["param_name"]}");')
         elif type_ == "static_param":
             if entry["param_name"]:
-                out.append(f'getStaticParam(&{get_member_name(entry)}, "{entry["param_name"]}");')
+                idx = static_param_names.index(entry["param_name"])
+                out.append(f'getStaticParam(&{get_member_name(entry)}, &sStaticParams[{idx}]);')
         elif type_ == "map_unit_param":
             if entry["param_name"]:
                 out.append(f'getMapUnitParam(&{get_member_name(entry)}, "{entry["param_name"]}");')
@@ -101,6 +103,7 @@ class CommonVIndex(enum.IntEnum):
 
 def generate_ai(class_dir: Path, name: str, info: list, parent: str, seen_virtual_functions: Set[int],
                 vtable: int) -> None:
+    aidef_name = name
     name = name[0].upper() + name[1:]
     if parent:
         parent = parent[0].upper() + parent[1:]
@@ -155,11 +158,19 @@ def generate_ai(class_dir: Path, name: str, info: list, parent: str, seen_virtua
     (class_dir / header_file_name).write_text("\n".join(out))
 
     # .cpp
+    slots = ""
+    if CommonVIndex.LoadParams in own_virtual_functions:
+        slots = ai_common.generate_static_param_slots("AI", aidef_name,
+                                                      ai_common.get_static_param_names(info))
     out = []
     out.append(f'#include "Game/AI/AI/{header_file_name}"')
+    if slots:
+        out.append('#include "KingSystem/ActorSystem/actAiClassDef.h"')
     out.append("")
     out.append("namespace uking::ai {")
     out.append("")
+    if slots:
+        out.append(slots)
     out.append(f"{cpp_class_name}::{cpp_class_name}(const InitArg& arg) : {parent_class_name}(arg) {{}}")
     out.append("")
     if CommonVIndex.Dtor in own_virtual_functions:
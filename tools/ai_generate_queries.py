@@ -6,6 +6,7 @@ from typing import List
 import oead
 from pathlib import Path
 import textwrap
+import ai_common
 
 
 def sort_params(params: list) -> list:
@@ -28,8 +29,8 @@ def generate_query_loadparam_body(query: dict, is_evfl: bool) -> str:
         for param in sort_params(query.get("DynamicInstParams", [])):
             out.append(f"load{param['Type']}(arg.param_accessor, \"{param['Name']}\");")
     else:
-        for param in sort_params(query.get("StaticInstParams", [])):
-            out.append(f"getStaticParam(&m{param['Name']}, \"{param['Name']}\");")
+        for idx, param in enumerate(sort_params(query.get("StaticInstParams", []))):
+            out.append(f"getStaticParam(&m{param['Name']}, &sStaticParams[{idx}]);")
 
         for param in sort_params(query.get("DynamicInstParams", [])):
             out.append(f"getDynamicParam(&m{param['Name']}, \"{param['Name']}\");")
@@ -75,7 +76,18 @@ def generate_query_param_member_vars(query: dict) -> str:
     return "\n".join(out)
 
 
-def generate_query(class_dir: Path, name: str, query) -> None:
+def generate_query_static_param_slots(aidef_name: str, query: dict) -> str:
+    """Only used by the AI version of loadParams. evfl queries read their parameters from the
+    event flow instead, so the table is emitted right before that function."""
+    if not query:
+        return ""
+
+    names = [param["Name"] for param in sort_params(query.get("StaticInstParams", []))]
+    return ai_common.generate_static_param_slots("Query", aidef_name, names)
+
+
+def generate_query(class_dir: Path, aidef_name: str, query) -> None:
+    name = aidef_name[0].upper() + aidef_name[1:]
     has_params = False
     if query != "":
         assert isinstance(query, oead.byml.Hash)
@@ -113,9 +125,12 @@ def generate_query(class_dir: Path, name: str, query) -> None:
     (class_dir / header_file_name).write_text("\n".join(out))
 
     # .cpp
+    slots = generate_query_static_param_slots(aidef_name, query)
     out = []
     out.append(f'#include "Game/AI/Query/{header_file_name}"')
     out.append(f'#include <evfl/query.h>')
+    if slots:
+        out.append('#include "KingSystem/ActorSystem/actAiClassDef.h"')
     out.append("")
     out.append("namespace uking::query {")
     out.append("")
@@ -130,6 +145,8 @@ def generate_query(class_dir: Path, name: str, query) -> None:
     out.append(textwrap.indent(generate_query_loadparam_body(query, is_evfl=True), " " * 4))
     out.append(f"}}")
     out.append("")
+    if slots:
+        out.append(slots)
     out.append(f"void {cpp_class_name}::loadParams() {{")
     out.append(textwrap.indent(generate_query_loadparam_body(query, is_evfl=False), " " * 4))
     out.append(f"}}")
@@ -198,9 +215,8 @@ def main() -> None:
         if isinstance(data, oead.byml.Hash):
             keys |= set(data.keys())
 
-        query_name = query_name[0].upper() + query_name[1:]
         generate_query(class_dir, query_name, data)
-        print(query_name)
+        print(query_name[0].upper() + query_name[1:])
         count += 1
 
     generate_query_factories(class_dir, aidef)
@@ -0,0 +1,143 @@
+#!/usr/bin/env python3
+"""Decodes AI trace files that were written by ksys::act::ai::Trace::writeFile."""
+import argparse
+import struct
+from collections import defaultdict
+from pathlib import Path
+from typing import Dict, List, NamedTuple, Optional
+
+_MAGIC = 0x52544941
+_VERSION = 2
+
+_HEADER = struct.Struct("<IIQIIII")
+_EVENT = struct.Struct("<QIIIIBB6x")
+_NAME_HEADER = struct.Struct("<II")
+
+_EVENT_TYPES = ("enter", "leave", "calc")
+
+
+class Event(NamedTuple):
+    tick: int
+    frame: int
+    actor_id: int
+    class_hash: int
+    value: int
+    type: str
+    thread_idx: int
+
+
+class Trace(NamedTuple):
+    tick_frequency: int
+    events: List[Event]
+    names: Dict[int, str]
+    num_dropped_events: int
+
+    def get_name(self, class_hash: int) -> str:
+        return self.names.get(class_hash, f"<{class_hash:08x}>")
+
+    def ticks_to_us(self, ticks: int) -> float:
+        return ticks * 1_000_000 / self.tick_frequency
+
+
+def read_trace(path: Path) -> Trace:
+    data = path.read_bytes()
+    magic, version, tick_frequency, num_events, num_names, num_dropped, _ = \
+        _HEADER.unpack_from(data, 0)
+    if magic != _MAGIC:
+        raise ValueError(f"{path}: not an AI trace file")
+    if version != _VERSION:
+        raise ValueError(f"{path}: unsupported version {version}")
+
+    offset = _HEADER.size
+    events = []
+    for _ in range(num_events):
+        tick, frame, actor_id, class_hash, value, type_, thread_idx = \
+            _EVENT.unpack_from(data, offset)
+        events.append(Event(tick, frame, actor_id, class_hash, value, _EVENT_TYPES[type_],
+                            thread_idx))
+        offset += _EVENT.size
+
+    names = dict()
+    for _ in range(num_names):
+        class_hash, length = _NAME_HEADER.unpack_from(data, offset)
+        offset += _NAME_HEADER.size
+        names[class_hash] = data[offset:offset + length].decode("utf-8", errors="replace")
+        offset += length
+
+    return Trace(tick_frequency, events, names, num_dropped)
+
+
+def print_class_costs(trace: Trace, limit: int) -> None:
+    calc_count: Dict[int, int] = defaultdict(int)
+    calc_total: Dict[int, int] = defaultdict(int)
+    calc_max: Dict[int, int] = defaultdict(int)
+    enter_count: Dict[int, int] = defaultdict(int)
+
+    for event in trace.events:
+        if event.type == "calc":
+            calc_count[event.class_hash] += 1
+            calc_total[event.class_hash] += event.value
+            calc_max[event.class_hash] = max(calc_max[event.class_hash], event.value)
+        elif event.type == "enter":
+            enter_count[event.class_hash] += 1
+
+    print(f"{'class':<48} {'calls':>8} {'total ms':>10} {'mean us':>9} {'max us':>9} "
+          f"{'enters':>7}")
+    ranked = sorted(calc_total.keys(), key=lambda h: calc_total[h], reverse=True)
+    for class_hash in ranked[:limit]:
+        count = calc_count[class_hash]
+        total_us = trace.ticks_to_us(calc_total[class_hash])
+        print(f"{trace.get_name(class_hash):<48} {count:>8} {total_us / 1000:>10.3f} "
+              f"{total_us / count:>9.2f} {trace.ticks_to_us(calc_max[class_hash]):>9.2f} "
+              f"{enter_count[class_hash]:>7}")
+
+
+def print_actor_timeline(trace: Trace, actor_id: int, include_calc: bool) -> None:
+    events = [e for e in trace.events if e.actor_id == actor_id]
+    if not events:
+        print(f"no events for actor {actor_id}")
+        return
+
+    events.sort(key=lambda e: e.tick)
+    base_tick = events[0].tick
+    depth = 0
+    for event in events:
+        if event.type == "calc" and not include_calc:
+            continue
+
+        if event.type == "leave":
+            depth = max(depth - 1, 0)
+
+        time_ms = trace.ticks_to_us(event.tick - base_tick) / 1000
+        line = f"{event.frame:>7} {time_ms:>10.3f}  {'  ' * depth}{event.type:<6}" \
+               f"{trace.get_name(event.class_hash)}"
+        if event.type == "calc":
+            line += f" ({trace.ticks_to_us(event.value):.2f} us)"
+        print(line)
+
+        if event.type == "enter":
+            depth += 1
+
+
+def main() -> None:
+    parser = argparse.ArgumentParser("Decode AI trace files.")
+    parser.add_argument("trace", type=Path, help="Path to the trace file")
+    parser.add_argument("--actor", type=lambda x: int(x, 0),
+                        help="Print the state timeline of an actor instead of cost tables")
+    parser.add_argument("--calc", action="store_true", help="Include calc events in timelines")
+    parser.add_argument("--limit", type=int, default=50, help="Number of classes to print")
+    args = parser.parse_args()
+
+    trace = read_trace(args.trace)
+    print(f"{len(trace.events)} events, {trace.num_dropped_events} dropped")
+    print()
+
+    actor_id: Optional[int] = args.actor
+    if actor_id is not None:
+        print_actor_timeline(trace, actor_id, args.calc)
+    else:
+        print_class_costs(trace, args.limit)
+
+
+if __name__ == "__main__":
+    main()